@@ -10,6 +10,7 @@
 #include <AMReX_PROB_AMR_F.H>
 #include <AMReX_Amr.H>
 #include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX_Utility.H>
 #include <AMReX_DistributionMapping.H>
 #include <AMReX_FabSet.H>
@@ -89,6 +90,7 @@ namespace
     bool checkpoint_files_output;
     bool precreateDirectories;
     bool prereadFAHeaders;
+    bool plot_batch_derive;
     VisMF::Header::Version plot_headerversion(VisMF::Header::Version_v1);
     VisMF::Header::Version checkpoint_headerversion(VisMF::Header::Version_v1);
 }
@@ -101,6 +103,22 @@ Amr::UsingPrecreateDirectories () noexcept
     return precreateDirectories;
 }
 
+int
+Amr::LevelSubSteps (int lev) const
+{
+    int n = 1;
+    for (int l = 1; l <= lev; ++l) {
+        n *= n_cycle[l];
+    }
+    return n;
+}
+
+bool
+Amr::PlotBatchDerive () noexcept
+{
+    return plot_batch_derive;
+}
+
 void
 Amr::Initialize ()
 {
@@ -127,6 +145,7 @@ Amr::Initialize ()
     compute_new_dt_on_regrid = 0;
     precreateDirectories     = true;
     prereadFAHeaders         = true;
+    plot_batch_derive        = false;
     plot_headerversion       = VisMF::Header::Version_v1;
     checkpoint_headerversion = VisMF::Header::Version_v1;
 #if defined(AMREX_USE_SENSEI_INSITU) && !defined(AMREX_NO_SENSEI_AMR_INST)
@@ -223,6 +242,22 @@ Amr::Amr (const RealBox* rb, int max_level_in, const Vector<int>& n_cell_in, int
     InitAmr();
 }
 
+void
+Amr::registerStateMemory ()
+{
+    ClearStateMemory();
+    const DescriptorList& desc_lst = AmrLevel::get_desc_lst();
+    for (int typ = 0; typ < desc_lst.size(); ++typ) {
+        int ntime = StateData::nTimeLevels();
+        if (!amr_level.empty() && amr_level[0]) {
+            StateData const& sd = amr_level[0]->get_state_data(typ);
+            ntime = int(sd.hasNewData()) + int(sd.hasOldData());
+        }
+        AddStateMemory(desc_lst[typ].getType(), ntime*desc_lst[typ].nComp(),
+                       IntVect(desc_lst[typ].nExtra()));
+    }
+}
+
 void
 Amr::InitAmr ()
 {
@@ -234,6 +269,10 @@ Amr::InitAmr ()
     //
     levelbld->variableSetUp();
     //
+    // Register state data for memory estimates.
+    //
+    registerStateMemory();
+    //
     // Set default values.
     //
     plot_int               = -1;
@@ -722,6 +761,8 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    finishAsyncCheckPoint();
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -1705,6 +1746,9 @@ Amr::checkPoint ()
     BL_PROFILE_REGION_START("Amr::checkPoint()");
     BL_PROFILE("Amr::checkPoint()");
 
+    // Back-pressure: only one asynchronous checkpoint can be outstanding.
+    finishAsyncCheckPoint();
+
     VisMF::SetNOutFiles(checkpoint_nfiles);
     //
     // In checkpoint files always write out FABs in NATIVE format.
@@ -1731,8 +1775,10 @@ Amr::checkPoint ()
   amrex::StreamRetry sretry(ckfile, abort_on_stream_retry_failure,
                              stream_max_tries);
 
-  // For AsyncOut, we need to turn off stream retry and write to ckfile directly.
-  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile : (ckfile + ".temp");
+  // For AsyncOut, we need to turn off stream retry.  The data, the headers
+  // and the rename to ckfile are completed in the background.
+  const bool async_out = AsyncOut::UseAsyncOut();
+  const std::string ckfileTemp = ckfile + ".temp";
 
   while(sretry.TryFileOutput()) {
 
@@ -1763,9 +1809,13 @@ Amr::checkPoint ()
 
     VisMF::IO_Buffer io_buffer(VisMF::GetIOBufferSize());
 
-    std::ofstream HeaderFile;
+    std::ofstream HeaderFileStream;
+    std::ostringstream HeaderStringStream;
+    std::ostream& HeaderFile = async_out
+        ? static_cast<std::ostream&>(HeaderStringStream)
+        : static_cast<std::ostream&>(HeaderFileStream);
 
-    HeaderFile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+    HeaderFileStream.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
 
     int old_prec = 0;
 
@@ -1774,11 +1824,12 @@ Amr::checkPoint ()
         //
         // Only the IOProcessor() writes to the header file.
         //
-        HeaderFile.open(HeaderFileName.c_str(), std::ios::out | std::ios::trunc |
-                                                std::ios::binary);
-
-        if ( ! HeaderFile.good()) {
-            amrex::FileOpenFailed(HeaderFileName);
+        if ( ! async_out) {
+            HeaderFileStream.open(HeaderFileName.c_str(), std::ios::out | std::ios::trunc |
+                                                          std::ios::binary);
+            if ( ! HeaderFileStream.good()) {
+                amrex::FileOpenFailed(HeaderFileName);
+            }
         }
 
         old_prec = static_cast<int>(HeaderFile.precision(17));
@@ -1821,18 +1872,38 @@ Amr::checkPoint ()
 
     if (ParallelDescriptor::IOProcessor()) {
         const Vector<std::string> &FAHeaderNames = StateData::FabArrayHeaderNames();
-        if(!FAHeaderNames.empty()) {
-            std::string FAHeaderFilesName = ckfileTemp + "/FabArrayHeaders.txt";
-            std::ofstream FAHeaderFile(FAHeaderFilesName.c_str(),
-                                       std::ios::out | std::ios::trunc |
-                                       std::ios::binary);
-            if ( ! FAHeaderFile.good()) {
-                amrex::FileOpenFailed(FAHeaderFilesName);
+        auto write_headers = [=, header = HeaderStringStream.str()] ()
+        {
+            if (async_out) {
+                std::ofstream ofs(HeaderFileName.c_str(), std::ios::out | std::ios::trunc |
+                                                          std::ios::binary);
+                if ( ! ofs.good()) {
+                    amrex::FileOpenFailed(HeaderFileName);
+                }
+                ofs.write(header.data(), static_cast<std::streamsize>(header.size()));
+                if ( ! ofs.good()) {
+                    amrex::Error("Amr::checkpoint() failed");
+                }
             }
 
-            for(int i(0); i < FAHeaderNames.size(); ++i) {
-                FAHeaderFile << FAHeaderNames[i] << '\n';
+            if(!FAHeaderNames.empty()) {
+                std::string FAHeaderFilesName = ckfileTemp + "/FabArrayHeaders.txt";
+                std::ofstream FAHeaderFile(FAHeaderFilesName.c_str(),
+                                           std::ios::out | std::ios::trunc |
+                                           std::ios::binary);
+                if ( ! FAHeaderFile.good()) {
+                    amrex::FileOpenFailed(FAHeaderFilesName);
+                }
+
+                for(int i(0); i < FAHeaderNames.size(); ++i) {
+                    FAHeaderFile << FAHeaderNames[i] << '\n';
+                }
             }
+        };
+        if (async_out) {
+            AsyncOut::Submit(std::move(write_headers));
+        } else {
+            write_headers();
         }
     }
 
@@ -1856,12 +1927,18 @@ Amr::checkPoint ()
         amrex::Print() << "checkPoint() time = " << dCheckPointTime << " secs." << '\n';
     }
 
-    if (AsyncOut::UseAsyncOut()) {
+    if (async_out) {
+        // Jobs run in order, so this one marks the end of the writes.
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        AsyncOut::Submit([=] () { done->store(true); });
+        async_checkpoint_done = std::move(done);
+        async_checkpoint_temp = ckfileTemp;
+        async_checkpoint_file = ckfile;
         break;
     } else {
         ParallelDescriptor::Barrier("Amr::checkPoint::end");
         if(ParallelDescriptor::IOProcessor()) {
-            HeaderFile.close();
+            HeaderFileStream.close();
             if (std::rename(ckfileTemp.c_str(), ckfile.c_str())) {
                 amrex::Abort("Amr::checkPoint: std::rename failed");
             }
@@ -1880,6 +1957,33 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+void
+Amr::finishAsyncCheckPoint (bool wait)
+{
+    if (async_checkpoint_file.empty()) { return; }
+
+    BL_PROFILE("Amr::finishAsyncCheckPoint()");
+
+    if (!wait) {
+        bool done = async_checkpoint_done->load();
+        ParallelAllReduce::And(done, ParallelDescriptor::Communicator());
+        if (!done) { return; }
+    }
+
+    AsyncOut::Finish();
+    ParallelDescriptor::Barrier("Amr::finishAsyncCheckPoint");
+    if (ParallelDescriptor::IOProcessor()) {
+        if (std::rename(async_checkpoint_temp.c_str(), async_checkpoint_file.c_str())) {
+            amrex::Abort("Amr::finishAsyncCheckPoint: std::rename failed");
+        }
+    }
+    ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
+
+    async_checkpoint_temp.clear();
+    async_checkpoint_file.clear();
+    async_checkpoint_done.reset();
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -2101,6 +2205,9 @@ Amr::coarseTimeStep (Real stop_time)
 
     run_strt = amrex::second() ;
 
+    // Complete the previous checkpoint if it has been written.
+    finishAsyncCheckPoint(false);
+
     //
     // Compute new dt.
     //
@@ -2128,6 +2235,9 @@ Amr::coarseTimeStep (Real stop_time)
 
     BL_PROFILE_REGION_START(stepName.str());
     timeStep(0,cumtime,1,1,stop_time);
+
+    // The time levels the state data actually keep are known now.
+    registerStateMemory();
     BL_PROFILE_REGION_STOP(stepName.str());
 
     cumtime += dt_level[0];
@@ -2647,7 +2757,7 @@ Amr::regrid (int  lbase,
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
         else if (new_dmap[lev].empty()) {
-            new_dmap[lev].define(new_grid_places[lev]);
+            new_dmap[lev] = MakeDistributionMap(lev, new_grid_places[lev]);
         }
 
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
@@ -3060,7 +3170,7 @@ Amr::bldFineLevels (Real strt_time)
         //
         finest_level = new_finest;
 
-        DistributionMapping new_dm {new_grids[new_finest]};
+        DistributionMapping new_dm = MakeDistributionMap(new_finest, new_grids[new_finest]);
 
         AmrLevel* level = (*levelbld)(*this,
                                       new_finest,
@@ -3296,6 +3406,7 @@ Amr::initPltAndChk ()
 
     pp.queryAdd("precreateDirectories", precreateDirectories);
     pp.queryAdd("prereadFAHeaders", prereadFAHeaders);
+    pp.queryAdd("plot_batch_derive", plot_batch_derive);
 
     int phvInt(plot_headerversion), chvInt(checkpoint_headerversion);
     pp.queryAdd("plot_headerversion", phvInt);
@@ -337,10 +337,19 @@ AmrLevel::writePlotFile (const std::string& dir,
     // derived
     if (!derive_names.empty())
     {
-        for (auto const& dname : derive_names)
+        if (Amr::PlotBatchDerive())
         {
-            derive(dname, cur_time, plotMF, cnt);
-            cnt += derive_lst.get(dname)->numDerive();
+            derive(Vector<std::string>(derive_names.begin(), derive_names.end()),
+                   cur_time, plotMF, cnt);
+            cnt += num_derive;
+        }
+        else
+        {
+            for (auto const& dname : derive_names)
+            {
+                derive(dname, cur_time, plotMF, cnt);
+                cnt += derive_lst.get(dname)->numDerive();
+            }
         }
     }
 
@@ -1768,11 +1777,7 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
 #endif
             for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
             {
-                const Box& bx = mfi.growntilebox();
-                FArrayBox& derfab = mf[mfi];
-                FArrayBox const& datafab = srcMF[mfi];
-                const int dncomp = rec->numDerive();
-                rec->derFuncFab()(bx, derfab, dcomp, dncomp, datafab, geom, time, rec->getBC(), level);
+                deriveFab(*rec, mfi.growntilebox(), mf[mfi], dcomp, srcMF[mfi], index, time, mfi.index());
             }
         }
         else
@@ -1782,44 +1787,7 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
 #endif
         for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
         {
-            int         idx     = mfi.index();
-            Real*       ddat    = mf[mfi].dataPtr(dcomp);
-            const int*  dlo     = mf[mfi].loVect();
-            const int*  dhi     = mf[mfi].hiVect();
-            const Box&  gtbx    = mfi.growntilebox();
-            const int*  lo      = gtbx.loVect();
-            const int*  hi      = gtbx.hiVect();
-            int         n_der   = rec->numDerive();
-            Real*       cdat    = srcMF[mfi].dataPtr();
-            const int*  clo     = srcMF[mfi].loVect();
-            const int*  chi     = srcMF[mfi].hiVect();
-            int         n_state = rec->numState();
-            const int*  dom_lo  = state[index].getDomain().loVect();
-            const int*  dom_hi  = state[index].getDomain().hiVect();
-            const Real* dx      = geom.CellSize();
-            const int*  bcr     = rec->getBC();
-            const RealBox& temp = RealBox(gtbx,geom.CellSize(),geom.ProbLo());
-            const Real* xlo     = temp.lo();
-            Real        dt      = parent->dtLevel(level);
-
-            if (rec->derFunc() != nullptr) {
-               rec->derFunc()(ddat,AMREX_ARLIM(dlo),AMREX_ARLIM(dhi),&n_der,
-                              cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),&n_state,
-                              lo,hi,dom_lo,dom_hi,dx,xlo,&time,&dt,bcr,
-                              &level,&idx);
-            } else if (rec->derFunc3D() != nullptr) {
-               const int *bc3D = rec->getBC3D();
-               rec->derFunc3D()(ddat,AMREX_ARLIM_3D(dlo),AMREX_ARLIM_3D(dhi),&n_der,
-                                cdat,AMREX_ARLIM_3D(clo),AMREX_ARLIM_3D(chi),&n_state,
-                                AMREX_ARLIM_3D(lo),AMREX_ARLIM_3D(hi),
-                                AMREX_ARLIM_3D(dom_lo),AMREX_ARLIM_3D(dom_hi),
-                                AMREX_ZFILL(dx),AMREX_ZFILL(xlo),
-                                &time,&dt,
-                                bc3D,
-                                &level,&idx);
-            } else {
-               amrex::Error("AmrLevel::derive: no function available");
-            }
+            deriveFab(*rec, mfi.growntilebox(), mf[mfi], dcomp, srcMF[mfi], index, time, mfi.index());
         }
         }
     }
@@ -1834,6 +1802,194 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
     }
 }
 
+void
+AmrLevel::derive (const Vector<std::string>& names, Real time, MultiFab& mf, int dcomp)
+{
+    BL_PROFILE("AmrLevel::derive(batch)");
+
+    const int ngrow = mf.nGrow();
+    const int ntypes = desc_lst.size();
+
+    struct DeriveItem
+    {
+        const DeriveRec* rec;
+        int dcomp;
+        int ngrow_src;
+    };
+    Vector<DeriveItem> items;
+
+    // For each state type, the components needed by any of the derived
+    // quantities and the number of ghost cells.
+    Vector<Vector<int>> pos(ntypes);
+    Vector<int> ngrow_typ(ntypes, -1);
+
+    int dc = dcomp;
+    for (auto const& name : names)
+    {
+        int index, scomp, ncomp;
+        const DeriveRec* rec = derive_lst.get(name);
+        if (isStateVariable(name,index,scomp) || rec == nullptr)
+        {
+            derive(name, time, mf, dc);
+            ++dc;
+            continue;
+        }
+
+        rec->getRange(0,index,scomp,ncomp);
+        int ngrow_src = ngrow;
+        {
+            Box bx0 = state[index].boxArray()[0];
+            Box bx1 = rec->boxMap()(bx0);
+            ngrow_src += bx0.smallEnd(0) - bx1.smallEnd(0);
+        }
+
+        for (int k = 0; k < rec->numRange(); ++k)
+        {
+            rec->getRange(k,index,scomp,ncomp);
+            if (pos[index].empty()) { pos[index].resize(desc_lst[index].nComp(), -1); }
+            for (int n = scomp; n < scomp+ncomp; ++n) { pos[index][n] = 0; }
+            ngrow_typ[index] = std::max(ngrow_typ[index], ngrow_src);
+        }
+
+        items.push_back(DeriveItem{rec, dc, ngrow_src});
+        dc += rec->numDerive();
+    }
+
+    if (items.empty()) { return; }
+
+    // Fill the state data once, one FillPatch per contiguous run of needed
+    // components.
+    Vector<std::unique_ptr<MultiFab>> src(ntypes);
+    for (int typ = 0; typ < ntypes; ++typ)
+    {
+        if (ngrow_typ[typ] < 0) { continue; }
+        int nneeded = 0;
+        for (auto& p : pos[typ]) {
+            if (p >= 0) { p = nneeded++; }
+        }
+        src[typ] = std::make_unique<MultiFab>(state[typ].boxArray(), dmap, nneeded,
+                                              ngrow_typ[typ], MFInfo(), *m_factory);
+        const int nc = static_cast<int>(pos[typ].size());
+        for (int n = 0; n < nc; )
+        {
+            if (pos[typ][n] < 0) { ++n; continue; }
+            int nrun = 1;
+            while (n+nrun < nc && pos[typ][n+nrun] >= 0) { ++nrun; }
+            FillPatch(*this,*src[typ],ngrow_typ[typ],time,typ,n,nrun,pos[typ][n]);
+            n += nrun;
+        }
+    }
+
+    // A derived quantity whose ranges are consecutive in the filled data
+    // can use an alias.  Otherwise, its state data are copied to a
+    // temporary on each tile.
+    Vector<int> alias_type(items.size(), -1);
+    Vector<int> alias_comp(items.size(), -1);
+    for (int i = 0; i < static_cast<int>(items.size()); ++i)
+    {
+        const DeriveRec* rec = items[i].rec;
+        int index0, scomp0, ncomp0;
+        rec->getRange(0,index0,scomp0,ncomp0);
+        bool consecutive = true;
+        for (int k = 1, next = pos[index0][scomp0]+ncomp0; k < rec->numRange(); ++k)
+        {
+            int index, scomp, ncomp;
+            rec->getRange(k,index,scomp,ncomp);
+            if (index != index0 || pos[index][scomp] != next) {
+                consecutive = false;
+                break;
+            }
+            next += ncomp;
+        }
+        if (consecutive) {
+            alias_type[i] = index0;
+            alias_comp[i] = pos[index0][scomp0];
+        }
+    }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.growntilebox();
+        for (int i = 0; i < static_cast<int>(items.size()); ++i)
+        {
+            const DeriveRec& rec = *items[i].rec;
+            int index, scomp, ncomp;
+            if (alias_type[i] >= 0)
+            {
+                FArrayBox datafab((*src[alias_type[i]])[mfi], amrex::make_alias,
+                                  alias_comp[i], rec.numState());
+                rec.getRange(rec.numRange()-1,index,scomp,ncomp);
+                deriveFab(rec, bx, mf[mfi], items[i].dcomp, datafab, index, time, mfi.index());
+            }
+            else
+            {
+                rec.getRange(0,index,scomp,ncomp);
+                const Box& sbx = amrex::grow(amrex::convert(bx, state[index].boxArray().ixType()),
+                                             items[i].ngrow_src-ngrow);
+                FArrayBox datafab(sbx, rec.numState(), The_Async_Arena());
+                for (int k = 0, n = 0; k < rec.numRange(); ++k, n += ncomp)
+                {
+                    rec.getRange(k,index,scomp,ncomp);
+                    datafab.copy<RunOn::Device>((*src[index])[mfi], sbx, pos[index][scomp],
+                                                sbx, n, ncomp);
+                }
+                deriveFab(rec, bx, mf[mfi], items[i].dcomp, datafab, index, time, mfi.index());
+            }
+        }
+    }
+}
+
+void
+AmrLevel::deriveFab (const DeriveRec& rec, const Box& bx, FArrayBox& derfab, int dcomp,
+                     FArrayBox const& datafab, int state_index, Real time, int idx)
+{
+    if (rec.derFuncFab() != nullptr)
+    {
+        rec.derFuncFab()(bx, derfab, dcomp, rec.numDerive(), datafab, geom, time, rec.getBC(), level);
+        return;
+    }
+
+    Real*       ddat    = derfab.dataPtr(dcomp);
+    const int*  dlo     = derfab.loVect();
+    const int*  dhi     = derfab.hiVect();
+    const int*  lo      = bx.loVect();
+    const int*  hi      = bx.hiVect();
+    int         n_der   = rec.numDerive();
+    auto*       cdat    = const_cast<Real*>(datafab.dataPtr()); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    const int*  clo     = datafab.loVect();
+    const int*  chi     = datafab.hiVect();
+    int         n_state = rec.numState();
+    const int*  dom_lo  = state[state_index].getDomain().loVect();
+    const int*  dom_hi  = state[state_index].getDomain().hiVect();
+    const Real* dx      = geom.CellSize();
+    const int*  bcr     = rec.getBC();
+    const RealBox& temp = RealBox(bx,geom.CellSize(),geom.ProbLo());
+    const Real* xlo     = temp.lo();
+    Real        dt      = parent->dtLevel(level);
+
+    if (rec.derFunc() != nullptr) {
+       rec.derFunc()(ddat,AMREX_ARLIM(dlo),AMREX_ARLIM(dhi),&n_der,
+                     cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),&n_state,
+                     lo,hi,dom_lo,dom_hi,dx,xlo,&time,&dt,bcr,
+                     &level,&idx);
+    } else if (rec.derFunc3D() != nullptr) {
+       const int *bc3D = rec.getBC3D();
+       rec.derFunc3D()(ddat,AMREX_ARLIM_3D(dlo),AMREX_ARLIM_3D(dhi),&n_der,
+                       cdat,AMREX_ARLIM_3D(clo),AMREX_ARLIM_3D(chi),&n_state,
+                       AMREX_ARLIM_3D(lo),AMREX_ARLIM_3D(hi),
+                       AMREX_ARLIM_3D(dom_lo),AMREX_ARLIM_3D(dom_hi),
+                       AMREX_ZFILL(dx),AMREX_ZFILL(xlo),
+                       &time,&dt,
+                       bc3D,
+                       &level,&idx);
+    } else {
+       amrex::Error("AmrLevel::derive: no function available");
+    }
+}
+
 //! Update the distribution maps in StateData based on the size of the map
 void
 AmrLevel::UpdateDistributionMaps ( DistributionMapping& update_dmap )
@@ -4,8 +4,13 @@
 #include <AMReX_Cluster.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelContext.H>
 #include <AMReX_Print.H>
 
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
 namespace amrex {
 
 AmrMesh::AmrMesh ()
@@ -374,6 +379,10 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("check_input", check_input);
 
+    pp.queryAdd("memory_budget", memory_budget);
+
+    pp.queryAdd("hierarchy_balance", hierarchy_balance);
+
     finest_level = -1;
 
     if (check_input) { checkInput(); }
@@ -774,6 +783,10 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             }
         }
     }
+
+    if (memory_budget > 0) {
+        EnforceMemoryBudget(lbase, new_finest, new_grids);
+    }
 }
 
 void
@@ -784,7 +797,7 @@ AmrMesh::MakeNewGrids (Real time)
         finest_level = 0;
 
         const BoxArray& ba = MakeBaseGrids();
-        DistributionMapping dm(ba);
+        DistributionMapping dm = MakeDistributionMap(0, ba);
         const auto old_num_setdm = num_setdm;
         const auto old_num_setba = num_setba;
 
@@ -812,7 +825,7 @@ AmrMesh::MakeNewGrids (Real time)
             if (new_finest <= finest_level) { break; }
             finest_level = new_finest;
 
-            DistributionMapping dm(new_grids[new_finest]);
+            DistributionMapping dm = MakeDistributionMap(new_finest, new_grids[new_finest]);
             const auto old_num_setdm = num_setdm;
 
             MakeNewLevelFromScratch(new_finest, time, new_grids[finest_level], dm);
@@ -843,7 +856,7 @@ AmrMesh::MakeNewGrids (Real time)
                 for (int lev = 1; lev <= new_finest; ++lev) {
                     if (new_grids[lev] != grids[lev]) {
                         grids_the_same = false;
-                        DistributionMapping dm(new_grids[lev]);
+                        DistributionMapping dm = MakeDistributionMap(lev, new_grids[lev]);
                         const auto old_num_setdm = num_setdm;
 
                         MakeNewLevelFromScratch(lev, time, new_grids[lev], dm);
@@ -1050,6 +1063,270 @@ AmrMesh::CountCells (int lev) noexcept
     return grids[lev].numPts();
 }
 
+void
+AmrMesh::AddStateMemory (IndexType ixtype, int ncomp, IntVect const& ngrow, int nbytes_per_comp)
+{
+    AMREX_ALWAYS_ASSERT(ncomp >= 0 && ngrow.allGE(IntVect(0)) && nbytes_per_comp > 0);
+    m_state_memory.push_back(StateMemory{ixtype, ncomp, ngrow, nbytes_per_comp});
+}
+
+Long
+AmrMesh::EstimateBoxMemory (const Box& bx) const noexcept
+{
+    Long r = 0;
+    for (auto const& sm : m_state_memory) {
+        Box const& b = amrex::grow(amrex::convert(bx, sm.ixtype), sm.ngrow);
+        r += b.numPts() * sm.ncomp * sm.nbytes;
+    }
+    return r;
+}
+
+Vector<Long>
+AmrMesh::EstimateMemoryUsage (int /*lev*/, const BoxArray& ba, const DistributionMapping& dm) const
+{
+    Vector<Long> r(ParallelContext::NProcsSub(), 0);
+    for (int i = 0, N = static_cast<int>(ba.size()); i < N; ++i) {
+        r[ParallelContext::global_to_local_rank(dm[i])] += EstimateBoxMemory(ba[i]);
+    }
+    return r;
+}
+
+Long
+AmrMesh::EstimateMaxMemoryPerRank (const Vector<BoxArray>& ba,
+                                   const Vector<DistributionMapping>& dm) const
+{
+    AMREX_ASSERT(ba.size() == dm.size());
+    Vector<Long> total(ParallelContext::NProcsSub(), 0);
+    for (int lev = 0; lev < ba.size(); ++lev) {
+        if (ba[lev].empty()) { continue; }
+        auto const& r = EstimateMemoryUsage(lev, ba[lev], dm[lev]);
+        for (int i = 0; i < total.size(); ++i) {
+            total[i] += r[i];
+        }
+    }
+    return *std::max_element(total.begin(), total.end());
+}
+
+DistributionMapping
+AmrMesh::MakeDistributionMap (int lev, const BoxArray& ba) const
+{
+    if (hierarchy_balance && lev > 0 && lev <= finest_level+1) {
+        return MakeHierarchyDistributionMap(lev, ba);
+    } else if (memory_budget > 0 && !m_state_memory.empty()) {
+        Vector<Real> cost(ba.size());
+        for (int i = 0, N = static_cast<int>(ba.size()); i < N; ++i) {
+            cost[i] = static_cast<Real>(EstimateBoxMemory(ba[i]));
+        }
+        return DistributionMapping::makeSFC(cost, ba);
+    } else {
+        return DistributionMapping(ba);
+    }
+}
+
+int
+AmrMesh::LevelSubSteps (int lev) const
+{
+    int n = 1;
+    for (int l = 0; l < lev; ++l) {
+        n *= MaxRefRatio(l);
+    }
+    return n;
+}
+
+DistributionMapping
+AmrMesh::MakeHierarchyDistributionMap (int lev, const BoxArray& ba) const
+{
+    BL_PROFILE("AmrMesh::MakeHierarchyDistributionMap()");
+
+    AMREX_ASSERT(lev > 0 && lev <= finest_level+1);
+
+    // A rank may get this much more than the average work of the level.
+    constexpr Real tolerance = Real(1.1);
+
+    const int nprocs = ParallelContext::NProcsSub();
+    const auto nboxes = static_cast<int>(ba.size());
+
+    auto work = [this] (int l, Box const& bx) -> Real
+    {
+        Long npts = bx.numPts();
+        if (l > 0) { npts += amrex::grow(bx,1).numPts() - bx.numPts(); }
+        return static_cast<Real>(npts) * static_cast<Real>(LevelSubSteps(l));
+    };
+
+    // Work of the coarser levels on each rank
+    Vector<Real> hierarchy_work(nprocs, Real(0.));
+    for (int l = 0; l < lev; ++l) {
+        const BoxArray& cba = grids[l];
+        const DistributionMapping& cdm = dmap[l];
+        for (int i = 0, N = static_cast<int>(cba.size()); i < N; ++i) {
+            hierarchy_work[ParallelContext::global_to_local_rank(cdm[i])] += work(l, cba[i]);
+        }
+    }
+
+    Vector<Real> box_work(nboxes);
+    for (int i = 0; i < nboxes; ++i) {
+        box_work[i] = work(lev, ba[i]);
+    }
+    const Real level_work = std::accumulate(box_work.begin(), box_work.end(), Real(0.));
+    const Real max_box_work = nboxes > 0
+        ? *std::max_element(box_work.begin(), box_work.end()) : Real(0.);
+    const Real target = std::max(tolerance*level_work/static_cast<Real>(nprocs), max_box_work);
+
+    // Rank owning most of the coarse region under each box
+    Vector<int> parent(nboxes, -1);
+    {
+        const BoxArray& cba = grids[lev-1];
+        const DistributionMapping& cdm = dmap[lev-1];
+        std::vector<std::pair<int,Box>> isects;
+        for (int i = 0; i < nboxes; ++i) {
+            cba.intersections(amrex::coarsen(ba[i], ref_ratio[lev-1]), isects);
+            Long best = 0;
+            for (auto const& is : isects) {
+                const Long npts = is.second.numPts();
+                const int rank = ParallelContext::global_to_local_rank(cdm[is.first]);
+                if (npts > best || (npts == best && rank < parent[i])) {
+                    best = npts;
+                    parent[i] = rank;
+                }
+            }
+        }
+    }
+
+    Vector<int> order(nboxes);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&] (int a, int b) { return box_work[a] > box_work[b]; });
+
+    // Ranks ordered by their work over all levels
+    using Entry = std::pair<Real,int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> pq;
+    for (int r = 0; r < nprocs; ++r) {
+        pq.emplace(hierarchy_work[r], r);
+    }
+
+    Vector<Real> level_load(nprocs, Real(0.));
+    Vector<int> pmap(nboxes);
+    std::vector<Entry> skipped;
+    for (int i : order)
+    {
+        const Real w = box_work[i];
+        int rank = parent[i];
+        if (rank < 0 || level_load[rank] + w > target)
+        {
+            rank = -1;
+            skipped.clear();
+            while (!pq.empty()) {
+                Entry e = pq.top();
+                pq.pop();
+                if (e.first != hierarchy_work[e.second]) { continue; } // stale
+                if (level_load[e.second] + w <= target) {
+                    rank = e.second;
+                    skipped.push_back(e);
+                    break;
+                }
+                skipped.push_back(e);
+            }
+            for (auto const& e : skipped) { pq.push(e); }
+            if (rank < 0) {
+                rank = static_cast<int>(std::min_element(level_load.begin(), level_load.end())
+                                        - level_load.begin());
+            }
+        }
+        level_load[rank] += w;
+        hierarchy_work[rank] += w;
+        pq.emplace(hierarchy_work[rank], rank);
+        pmap[i] = ParallelContext::local_to_global_rank(rank);
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
+void
+AmrMesh::EnforceMemoryBudget (int lbase, int& new_finest, Vector<BoxArray>& new_grids) const
+{
+    if (memory_budget <= 0 || m_state_memory.empty()) { return; }
+
+    BL_PROFILE("AmrMesh::EnforceMemoryBudget()");
+
+    // Estimated peak memory per process.  While a level is being remade,
+    // the old and new data of that level coexist.
+    auto peak_memory = [&] () -> Long
+    {
+        const int nprocs = ParallelContext::NProcsSub();
+        Vector<Long> total(nprocs, 0);
+        Vector<Long> transient(nprocs, 0);
+        for (int lev = 0; lev <= new_finest; ++lev) {
+            bool changed = (lev > lbase) && (lev > finest_level || new_grids[lev] != grids[lev]);
+            Vector<Long> r;
+            if (changed) {
+                r = EstimateMemoryUsage(lev, new_grids[lev], MakeDistributionMap(lev, new_grids[lev]));
+                if (lev <= finest_level) {
+                    auto const& rold = EstimateMemoryUsage(lev, grids[lev], dmap[lev]);
+                    for (int i = 0; i < nprocs; ++i) {
+                        transient[i] = std::max(transient[i], rold[i]);
+                    }
+                }
+            } else {
+                r = EstimateMemoryUsage(lev, grids[lev], dmap[lev]);
+            }
+            for (int i = 0; i < nprocs; ++i) {
+                total[i] += r[i];
+            }
+        }
+        Long mx = 0;
+        for (int i = 0; i < nprocs; ++i) {
+            mx = std::max(mx, total[i] + transient[i]);
+        }
+        return mx;
+    };
+
+    Long mem = peak_memory();
+    if (mem <= memory_budget) { return; }
+
+    if (verbose) {
+        amrex::Print() << "AmrMesh: estimated memory per rank " << mem
+                       << " bytes exceeds budget " << memory_budget << " bytes\n";
+    }
+
+    // Smaller grids give the load balancer more freedom to even out
+    // the memory across processes.
+    {
+        Vector<BoxArray> saved(new_grids.begin(), new_grids.begin()+new_finest+1);
+        for (int lev = lbase+1; lev <= new_finest; ++lev) {
+            if (lev > finest_level || new_grids[lev] != grids[lev]) {
+                ChopGrids(lev, new_grids[lev], 2*static_cast<int>(new_grids[lev].size()));
+            }
+        }
+        Long new_mem = peak_memory();
+        if (new_mem < mem) {
+            mem = new_mem;
+            if (verbose) {
+                amrex::Print() << "AmrMesh: chopped new grids, estimated memory per rank "
+                               << mem << " bytes\n";
+            }
+        } else {
+            for (int lev = lbase+1; lev <= new_finest; ++lev) {
+                new_grids[lev] = saved[lev];
+            }
+        }
+    }
+
+    // Reduce refinement by dropping the finest new levels.
+    while (mem > memory_budget && new_finest > lbase) {
+        new_grids[new_finest] = BoxArray();
+        --new_finest;
+        mem = peak_memory();
+        if (verbose) {
+            amrex::Print() << "AmrMesh: reduced finest level to " << new_finest
+                           << ", estimated memory per rank " << mem << " bytes\n";
+        }
+    }
+
+    if (mem > memory_budget) {
+        amrex::Warning("AmrMesh: estimated memory per rank exceeds amr.memory_budget");
+    }
+}
+
 std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
 {
     os << "  verbose = " << amr_mesh.verbose << "\n";
@@ -1074,6 +1351,8 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
+    os << "  memory_budget = " << amr_mesh.memory_budget << "\n";
+    os << "  hierarchy_balance = " << amr_mesh.hierarchy_balance << "\n";
     return os;
 }
 
@@ -23,6 +23,9 @@ namespace amrex {
  *
  * CellConservativeQuartic only works with ref ratio of 2 on cpu and gpu.
  *
+ * CellConservativeWENO works in 1D, 2D and 3D on cpu and gpu with ref ratio
+ * of 1, 2 or 4 in each direction.
+ *
  * FaceDivFree works in 2D and 3D on cpu and gpu.
  * The algorithm is restricted to ref ratio of 2.
  */
@@ -41,6 +44,7 @@ CellConservativeQuartic   quartic_interp;
 CellBilinear              cell_bilinear_interp;
 CellQuadratic             quadratic_interp;
 CellQuartic               cell_quartic_interp;
+CellConservativeWENO      cell_cons_weno_interp;
 
 Box
 NodeBilinear::CoarseBox (const Box& fine,
@@ -869,6 +873,61 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
     });
 }
 
+Box
+CellConservativeWENO::CoarseBox (const Box& fine, int ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    if (ratio > 1) { crse.grow(2); }
+    return crse;
+}
+
+Box
+CellConservativeWENO::CoarseBox (const Box& fine, const IntVect& ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    for (int dim = 0; dim < AMREX_SPACEDIM; dim++) {
+        if (ratio[dim] > 1) {
+            crse.grow(dim,2);
+        }
+    }
+    return crse;
+}
+
+void
+CellConservativeWENO::interp (const FArrayBox&  crse,
+                              int               crse_comp,
+                              FArrayBox&        fine,
+                              int               fine_comp,
+                              int               ncomp,
+                              const Box&        fine_region,
+                              const IntVect&    ratio,
+                              const Geometry&   /* crse_geom */,
+                              const Geometry&   /* fine_geom */,
+                              Vector<BCRec> const& /*bcr*/,
+                              int               /* actual_comp */,
+                              int               /* actual_state */,
+                              RunOn             runon)
+{
+    BL_PROFILE("CellConservativeWENO::interp()");
+    for (int dim = 0; dim < AMREX_SPACEDIM; ++dim) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ratio[dim] == 1 || ratio[dim] == 2 || ratio[dim] == 4,
+                                         "CellConservativeWENO: ratio must be 1, 2 or 4");
+    }
+
+    Box const& target_fine_region = fine_region & fine.box();
+    Box const& cbox = amrex::coarsen(target_fine_region, ratio);
+
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real>       const& finearr = fine.array();
+    bool limit = do_limiting;
+
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, cbox, ncomp, i, j, k, n,
+    {
+        ccweno_interp(i, j, k, n, finearr, fine_comp, crsearr, crse_comp,
+                      target_fine_region, ratio, limit);
+    });
+}
+
 Box
 FaceDivFree::CoarseBox (const Box& fine,
                         int        ratio)
@@ -11,6 +11,7 @@ MFPCInterp          mf_pc_interp;
 MFCellConsLinInterp mf_cell_cons_interp(false);
 MFCellConsLinInterp mf_lincc_interp(true);
 MFCellConsLinMinmaxLimitInterp mf_linear_slope_minmax_interp;
+MFCellConsWENOInterp mf_cell_cons_weno_interp;
 MFCellBilinear      mf_cell_bilinear_interp;
 
 // Nodal
@@ -413,6 +414,79 @@ MFCellConsLinMinmaxLimitInterp::interp (MultiFab const& crsemf, int ccomp, Multi
     }
 }
 
+Box
+MFCellConsWENOInterp::CoarseBox (const Box& fine, const IntVect& ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    for (int dim = 0; dim < AMREX_SPACEDIM; dim++) {
+        if (ratio[dim] > 1) {
+            crse.grow(dim,2);
+        }
+    }
+    return crse;
+}
+
+Box
+MFCellConsWENOInterp::CoarseBox (const Box& fine, int ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    if (ratio > 1) { crse.grow(2); }
+    return crse;
+}
+
+void
+MFCellConsWENOInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf, int fcomp, int nc,
+                              IntVect const& ng, Geometry const&, Geometry const&,
+                              Box const& dest_domain, IntVect const& ratio,
+                              Vector<BCRec> const&, int)
+{
+    AMREX_ASSERT(crsemf.nGrowVect() == 0);
+    for (int dim = 0; dim < AMREX_SPACEDIM; ++dim) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ratio[dim] == 1 || ratio[dim] == 2 || ratio[dim] == 4,
+                                         "MFCellConsWENOInterp: ratio must be 1, 2 or 4");
+    }
+
+    // Coarse cells covering the fine region of each box
+    IntVect minus2;
+    for (int dim = 0; dim < AMREX_SPACEDIM; dim++) {
+        minus2[dim] = (ratio[dim] > 1) ? -2 : 0;
+    }
+
+    bool limit = do_limiting;
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        auto const& crse = crsemf.const_arrays();
+        auto const& fine = finemf.arrays();
+        IntVect const fng = ng - finemf.nGrowVect();
+        ParallelFor(crsemf, minus2, nc,
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+        {
+            Box const& fbox = amrex::grow(Box(fine[box_no]), fng) & dest_domain;
+            ccweno_interp(i,j,k,n, fine[box_no], fcomp, crse[box_no], ccomp,
+                          fbox, ratio, limit);
+        });
+        Gpu::streamSynchronize();
+    } else
+#endif
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(finemf); mfi.isValid(); ++mfi) {
+            auto const& fine = finemf.array(mfi);
+            auto const& crse = crsemf.const_array(mfi);
+            Box const& fbox = amrex::grow(mfi.validbox(), ng) & dest_domain;
+            Box const& cbox = amrex::coarsen(fbox, ratio);
+            amrex::LoopConcurrentOnCpu(cbox, nc,
+            [&] (int i, int j, int k, int n) noexcept
+            {
+                ccweno_interp(i,j,k,n, fine, fcomp, crse, ccomp, fbox, ratio, limit);
+            });
+        }
+    }
+}
+
 Box
 MFCellBilinear::CoarseBox (const Box& fine, const IntVect& ratio)
 {
@@ -31,6 +31,7 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::fillpatch_fused_interp;
 
 #if defined(AMREX_USE_GPU)
 
@@ -63,6 +64,7 @@ IntVect FabArrayBase::comm_tile_size(AMREX_D_DECL(1024000, 8, 8));
 FabArrayBase::TACache              FabArrayBase::m_TheTileArrayCache;
 FabArrayBase::FBCache              FabArrayBase::m_TheFBCache;
 FabArrayBase::CPCache              FabArrayBase::m_TheCPCache;
+FabArrayBase::MBCPCache            FabArrayBase::m_TheMBCPCache;
 FabArrayBase::RB90Cache            FabArrayBase::m_TheRB90Cache;
 FabArrayBase::RB180Cache           FabArrayBase::m_TheRB180Cache;
 FabArrayBase::PolarBCache          FabArrayBase::m_ThePolarBCache;
@@ -76,6 +78,7 @@ std::multimap<FabArrayBase::BDKey,FabArrayBase::ParForInfo*> FabArrayBase::m_The
 FabArrayBase::CacheStats           FabArrayBase::m_TAC_stats("TileArrayCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FBC_stats("FBCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CPC_stats("CopyCache");
+FabArrayBase::CacheStats           FabArrayBase::m_MBCPC_stats("MultiBlockCopyCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FPinfo_stats("FillPatchCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CFinfo_stats("CrseFineCache");
 
@@ -101,6 +104,7 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::fillpatch_fused_interp = false;
 
     ParmParse pp("fabarray");
 
@@ -117,6 +121,7 @@ FabArrayBase::Initialize ()
     }
 
     pp.queryAdd("maxcomp",             FabArrayBase::MaxComp);
+    pp.queryAdd("fillpatch_fused_interp", FabArrayBase::fillpatch_fused_interp);
 
     if (MaxComp < 1) {
         MaxComp = 1;
@@ -137,6 +142,10 @@ FabArrayBase::Initialize ()
                      ([] () -> MemProfiler::MemInfo {
                          return {m_CPC_stats.bytes, m_CPC_stats.bytes_hwm};
                      }));
+    MemProfiler::add(m_MBCPC_stats.name, std::function<MemProfiler::MemInfo()>
+                     ([] () -> MemProfiler::MemInfo {
+                         return {m_MBCPC_stats.bytes, m_MBCPC_stats.bytes_hwm};
+                     }));
     MemProfiler::add(m_FPinfo_stats.name, std::function<MemProfiler::MemInfo()>
                      ([] () -> MemProfiler::MemInfo {
                          return {m_FPinfo_stats.bytes, m_FPinfo_stats.bytes_hwm};
@@ -613,6 +622,147 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
     return *new_cpc;
 }
 
+FabArrayBase::MBCPC::MBCPC (const FabArrayBase& dstfa, const FabArrayBase& srcfa,
+                            std::string key, CommMetaData&& cmd)
+    : CommMetaData(std::move(cmd)),
+      m_srcbdk(srcfa.getBDKey()),
+      m_dstbdk(dstfa.getBDKey()),
+      m_srcba(srcfa.boxArray()),
+      m_dstba(dstfa.boxArray()),
+      m_key(std::move(key))
+{}
+
+Long
+FabArrayBase::MBCPC::bytes () const
+{
+    Long cnt = sizeof(FabArrayBase::MBCPC) + static_cast<Long>(m_key.capacity());
+
+    if (m_LocTags) {
+        cnt += amrex::bytesOf(*m_LocTags);
+    }
+
+    if (m_SndTags) {
+        cnt += FabArrayBase::bytesOfMapOfCopyComTagContainers(*m_SndTags);
+    }
+
+    if (m_RcvTags) {
+        cnt += FabArrayBase::bytesOfMapOfCopyComTagContainers(*m_RcvTags);
+    }
+
+    return cnt;
+}
+
+void
+FabArrayBase::flushMBCPC (bool no_assertion) const
+{
+    amrex::ignore_unused(no_assertion);
+    BL_ASSERT(no_assertion || getBDKey() == m_bdkey);
+
+    std::vector<MBCPCacheIter> others;
+
+    auto er_it = m_TheMBCPCache.equal_range(m_bdkey);
+
+    for (auto it = er_it.first; it != er_it.second; ++it)
+    {
+        const BDKey& srckey = it->second->m_srcbdk;
+        const BDKey& dstkey = it->second->m_dstbdk;
+
+        BL_ASSERT((srckey==dstkey && srckey==m_bdkey) ||
+                  (m_bdkey==srckey) || (m_bdkey==dstkey));
+
+        if (srckey != dstkey) {
+            const BDKey& otherkey = (m_bdkey == srckey) ? dstkey : srckey;
+            auto o_er_it = m_TheMBCPCache.equal_range(otherkey);
+            for (auto oit = o_er_it.first; oit != o_er_it.second; ++oit)
+            {
+                if (it->second == oit->second) {
+                    others.push_back(oit);
+                }
+            }
+        }
+
+#ifdef AMREX_MEM_PROFILING
+        m_MBCPC_stats.bytes -= it->second->bytes();
+#endif
+        m_MBCPC_stats.recordErase(it->second->m_nuse);
+        delete it->second;
+    }
+
+    m_TheMBCPCache.erase(er_it.first, er_it.second);
+
+    for (auto const& it : others) {
+        m_TheMBCPCache.erase(it);
+    }
+}
+
+void
+FabArrayBase::flushMBCPCache ()
+{
+    std::vector<MBCPC*> cpcs;
+    for (auto const& it : m_TheMBCPCache)
+    {
+        if (it.first == it.second->m_srcbdk) {
+            m_MBCPC_stats.recordErase(it.second->m_nuse);
+            cpcs.push_back(it.second);
+        }
+    }
+    for (auto& c : cpcs) {
+        delete c;
+    }
+    m_TheMBCPCache.clear();
+#ifdef AMREX_MEM_PROFILING
+    m_MBCPC_stats.bytes = 0L;
+#endif
+}
+
+const FabArrayBase::CommMetaData&
+FabArrayBase::getMBCPC (const FabArrayBase& src, const std::string& key,
+                        const std::function<CommMetaData()>& f) const
+{
+    BL_PROFILE("FabArrayBase::getMBCPC()");
+
+    BL_ASSERT(getBDKey() == m_bdkey);
+    BL_ASSERT(src.getBDKey() == src.m_bdkey);
+
+    const BDKey& srckey = src.getBDKey();
+    const BDKey& dstkey =     getBDKey();
+
+    auto er_it = m_TheMBCPCache.equal_range(dstkey);
+
+    for (auto it = er_it.first; it != er_it.second; ++it)
+    {
+        if (it->second->m_srcbdk == srckey &&
+            it->second->m_dstbdk == dstkey &&
+            it->second->m_key    == key    &&
+            it->second->m_srcba  == src.boxArray() &&
+            it->second->m_dstba  == boxArray())
+        {
+            ++(it->second->m_nuse);
+            m_MBCPC_stats.recordUse();
+            return *(it->second);
+        }
+    }
+
+    // Have to build a new one
+    auto* new_cpc = new MBCPC(*this, src, key, f());
+
+#ifdef AMREX_MEM_PROFILING
+    m_MBCPC_stats.bytes += new_cpc->bytes();
+    m_MBCPC_stats.bytes_hwm = std::max(m_MBCPC_stats.bytes_hwm, m_MBCPC_stats.bytes);
+#endif
+
+    new_cpc->m_nuse = 1;
+    m_MBCPC_stats.recordBuild();
+    m_MBCPC_stats.recordUse();
+
+    m_TheMBCPCache.insert(er_it.second, MBCPCache::value_type(dstkey,new_cpc));
+    if (srckey != dstkey) {
+        m_TheMBCPCache.insert(            MBCPCache::value_type(srckey,new_cpc));
+    }
+
+    return *new_cpc;
+}
+
 //
 // Some stuff for fill boundary
 //
@@ -1791,12 +1941,14 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
                               const BoxConverter& coarsener,
                               const Box&          fdomain,
                               const Box&          cdomain,
-                              const EB2::IndexSpace* index_space)
+                              const EB2::IndexSpace* index_space,
+                              bool                dst_aligned)
     : m_srcbdk   (srcfa.getBDKey()),
       m_dstbdk   (dstfa.getBDKey()),
       m_dstdomain(dstdomain),
       m_dstng    (dstng),
-      m_coarsener(coarsener.clone())
+      m_coarsener(coarsener.clone()),
+      m_dst_aligned(dst_aligned)
 {
     amrex::ignore_unused(fdomain,cdomain,index_space);
     BL_PROFILE("FPinfo::FPinfo()");
@@ -1813,6 +1965,12 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
 
     BL_ASSERT(dstng.allLE(dstfa.nGrowVect()));
 
+    if (dst_aligned) {
+        AMREX_ASSERT(index_space == nullptr);
+        define_dst_aligned(srcba_simplified, dstfa, coarsener);
+        return;
+    }
+
     BoxList bl(boxtype);
     const int Ndst = static_cast<int>(dstba_simplified.size());
     const int nprocs = ParallelContext::NProcsSub();
@@ -1955,12 +2113,56 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
     }
 }
 
+void
+FabArrayBase::FPinfo::define_dst_aligned (const BoxArray& srcba_simplified,
+                                          const FabArrayBase& dstfa,
+                                          const BoxConverter& coarsener)
+{
+    // Each patch is computed from a single destination box so that it
+    // can be filled in place by the process owning that box.
+    const BoxArray& dstba = dstfa.boxArray();
+    const DistributionMapping& dstdm = dstfa.DistributionMap();
+    const IndexType& boxtype = dstba.ixType();
+
+    BoxList bl(boxtype);
+    Vector<int> pmap;
+    const int Ndst = static_cast<int>(dstba.size());
+    for (int i = 0; i < Ndst; ++i) {
+        Box bx = dstba[i];
+        bx.grow(m_dstng);
+        bx &= m_dstdomain;
+        if (bx.isEmpty()) { continue; }
+        BoxList const& leftover = srcba_simplified.complementIn(bx);
+        for (auto const& b : leftover) {
+            bl.push_back(b);
+            dst_idxs.push_back(i);
+            pmap.push_back(dstdm[i]);
+        }
+    }
+
+    if (bl.isEmpty()) { return; }
+
+    BoxList blcrse(boxtype);
+    blcrse.reserve(bl.size());
+    for (auto const& b : bl) {
+        blcrse.push_back(coarsener.doit(b));
+    }
+
+    ba_crse_patch.define(std::move(blcrse));
+    ba_fine_patch.define(std::move(bl));
+    dm_patch = DistributionMapping(std::move(pmap));
+
+    fact_crse_patch = std::make_unique<FArrayBoxFactory>();
+    fact_fine_patch = std::make_unique<FArrayBoxFactory>();
+}
+
 Long
 FabArrayBase::FPinfo::bytes () const
 {
     auto cnt = sizeof(FabArrayBase::FPinfo);
     cnt += sizeof(Box) * (ba_crse_patch.capacity() + ba_fine_patch.capacity());
     cnt += sizeof(int) * dm_patch.capacity();
+    cnt += sizeof(int) * dst_idxs.capacity();
     return static_cast<Long>(cnt);
 }
 
@@ -1971,7 +2173,8 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
                          const BoxConverter& coarsener,
                          const Geometry&     fgeom,
                          const Geometry&     cgeom,
-                         const EB2::IndexSpace* index_space)
+                         const EB2::IndexSpace* index_space,
+                         bool                dst_aligned)
 {
     BL_PROFILE("FabArrayBase::TheFPinfo()");
 
@@ -1994,6 +2197,7 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
             it->second->m_dstbdk    == dstkey    &&
             it->second->m_dstdomain == dstdomain &&
             it->second->m_dstng     == dstng     &&
+            it->second->m_dst_aligned == dst_aligned &&
             it->second->m_dstdomain.ixType() == dstdomain.ixType() &&
             it->second->m_coarsener->doit(it->second->m_dstdomain) == coarsener.doit(dstdomain))
         {
@@ -2005,7 +2209,7 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
 
     // Have to build a new one
     auto *new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener,
-                              fgeom.Domain(), cgeom.Domain(), index_space);
+                              fgeom.Domain(), cgeom.Domain(), index_space, dst_aligned);
 
 #ifdef AMREX_MEM_PROFILING
     m_FPinfo_stats.bytes += new_fpc->bytes();
@@ -2204,6 +2408,7 @@ FabArrayBase::Finalize ()
 {
     FabArrayBase::flushFBCache();
     FabArrayBase::flushCPCache();
+    FabArrayBase::flushMBCPCache();
     FabArrayBase::flushRB90Cache();
     FabArrayBase::flushRB180Cache();
     FabArrayBase::flushPolarBCache();
@@ -2218,6 +2423,7 @@ FabArrayBase::Finalize ()
         m_TAC_stats.print();
         m_FBC_stats.print();
         m_CPC_stats.print();
+        m_MBCPC_stats.print();
         m_FPinfo_stats.print();
         m_CFinfo_stats.print();
     }
@@ -2230,6 +2436,7 @@ FabArrayBase::Finalize ()
     m_TAC_stats = CacheStats("TileArrayCache");
     m_FBC_stats = CacheStats("FBCache");
     m_CPC_stats = CacheStats("CopyCache");
+    m_MBCPC_stats = CacheStats("MultiBlockCopyCache");
     m_FPinfo_stats = CacheStats("FillPatchCache");
     m_CFinfo_stats = CacheStats("CrseFineCache");
 
@@ -2438,6 +2645,7 @@ FabArrayBase::clearThisBD (bool no_assertion) const
             flushCFinfo(no_assertion);
             flushFB(no_assertion);
             flushCPC(no_assertion);
+            flushMBCPC(no_assertion);
             flushRB90(no_assertion);
             flushRB180(no_assertion);
             flushPolarB(no_assertion);
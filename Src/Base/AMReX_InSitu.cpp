@@ -0,0 +1,398 @@
+#include <AMReX_InSitu.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace amrex::InSitu {
+
+namespace {
+
+std::string product_name (std::string const& prefix, int step, std::string const& ext)
+{
+    return amrex::Concatenate(prefix, step) + ext;
+}
+
+}
+
+Operator Reductions (std::string filename)
+{
+    return [filename=std::move(filename)] (Data const& d)
+    {
+        const int ncomp = static_cast<int>(d.varnames.size());
+        Vector<Real> vmin(ncomp, std::numeric_limits<Real>::max());
+        Vector<Real> vmax(ncomp, std::numeric_limits<Real>::lowest());
+        Vector<Real> vsum(ncomp, Real(0.));
+        for (int K : d.mf.IndexArray()) {
+            auto const& a = d.mf.const_array(K);
+            amrex::LoopOnCpu(d.mf.box(K), ncomp, [&] (int i, int j, int k, int n) noexcept
+            {
+                vmin[n] = std::min(vmin[n], a(i,j,k,n));
+                vmax[n] = std::max(vmax[n], a(i,j,k,n));
+                vsum[n] += a(i,j,k,n);
+            });
+        }
+        ParallelReduce::Min(vmin.data(), ncomp, d.root, d.comm);
+        ParallelReduce::Max(vmax.data(), ncomp, d.root, d.comm);
+        ParallelReduce::Sum(vsum.data(), ncomp, d.root, d.comm);
+
+        if (d.isRoot()) {
+            const bool new_file = !amrex::FileExists(filename);
+            std::ofstream ofs(filename, std::ios::app);
+            if (!ofs.good()) { amrex::FileOpenFailed(filename); }
+            ofs.precision(std::numeric_limits<Real>::max_digits10);
+            if (new_file) {
+                ofs << "# step time";
+                for (auto const& name : d.varnames) {
+                    ofs << " " << name << "_min " << name << "_max " << name << "_mean";
+                }
+                ofs << "\n";
+            }
+            const auto npts = static_cast<Real>(d.geom.Domain().d_numPts());
+            ofs << d.step << " " << d.time;
+            for (int n = 0; n < ncomp; ++n) {
+                ofs << " " << vmin[n] << " " << vmax[n] << " " << vsum[n]/npts;
+            }
+            ofs << "\n";
+        }
+    };
+}
+
+Operator Histogram (int comp, Real lo, Real hi, int nbins, std::string prefix)
+{
+    AMREX_ALWAYS_ASSERT(nbins > 0 && hi > lo);
+    return [=, prefix=std::move(prefix)] (Data const& d)
+    {
+        // bins[0] is the underflow and bins[nbins+1] the overflow
+        Vector<Long> bins(nbins+2, 0);
+        const Real dxinv = Real(nbins) / (hi-lo);
+        for (int K : d.mf.IndexArray()) {
+            auto const& a = d.mf.const_array(K, comp);
+            amrex::LoopOnCpu(d.mf.box(K), [&] (int i, int j, int k) noexcept
+            {
+                const Real v = a(i,j,k);
+                int b;
+                if (v < lo) {
+                    b = 0;
+                } else if (v >= hi) {
+                    b = nbins+1;
+                } else {
+                    b = std::min(static_cast<int>((v-lo)*dxinv), nbins-1) + 1;
+                }
+                ++bins[b];
+            });
+        }
+        ParallelReduce::Sum(bins.data(), nbins+2, d.root, d.comm);
+
+        if (d.isRoot()) {
+            const std::string filename = product_name(prefix, d.step, ".txt");
+            std::ofstream ofs(filename);
+            if (!ofs.good()) { amrex::FileOpenFailed(filename); }
+            ofs.precision(std::numeric_limits<Real>::max_digits10);
+            ofs << "# " << d.varnames[comp] << " step " << d.step << " time " << d.time << "\n"
+                << "# underflow " << bins[0] << " overflow " << bins[nbins+1] << "\n"
+                << "# bin_lo bin_hi count\n";
+            for (int b = 0; b < nbins; ++b) {
+                ofs << lo + b/dxinv << " " << lo + (b+1)/dxinv << " " << bins[b+1] << "\n";
+            }
+        }
+    };
+}
+
+Operator Slice (int dir, Real coord, int comp, std::string prefix)
+{
+    AMREX_ALWAYS_ASSERT(dir >= 0 && dir < AMREX_SPACEDIM);
+    return [=, prefix=std::move(prefix)] (Data const& d)
+    {
+        const Box& domain = d.geom.Domain();
+        const int islice = static_cast<int>(std::floor((coord - d.geom.ProbLo(dir))
+                                                       * d.geom.InvCellSize(dir)));
+        if (islice < domain.smallEnd(dir) || islice > domain.bigEnd(dir)) { return; }
+
+        Box plane = domain;
+        plane.setRange(dir, islice);
+        // The product is small, so everyone fills its part of the whole
+        // plane and the planes are summed on the root.
+        FArrayBox fab(plane, 1, The_Cpu_Arena());
+        fab.setVal<RunOn::Host>(Real(0.));
+        auto const& p = fab.array();
+        for (int K : d.mf.IndexArray()) {
+            const Box& b = d.mf.box(K) & plane;
+            if (b.ok()) {
+                auto const& a = d.mf.const_array(K, comp);
+                amrex::LoopOnCpu(b, [&] (int i, int j, int k) noexcept
+                {
+                    p(i,j,k) = a(i,j,k);
+                });
+            }
+        }
+        ParallelReduce::Sum(fab.dataPtr(), static_cast<int>(plane.numPts()), d.root, d.comm);
+
+        if (d.isRoot()) {
+            const std::string filename = product_name(prefix, d.step, ".txt");
+            std::ofstream ofs(filename);
+            if (!ofs.good()) { amrex::FileOpenFailed(filename); }
+            ofs.precision(std::numeric_limits<Real>::max_digits10);
+            ofs << "# " << d.varnames[comp] << " step " << d.step << " time " << d.time << "\n"
+                << "# box " << plane << "\n";
+            amrex::LoopOnCpu(plane, [&] (int i, int j, int k) noexcept
+            {
+                ofs << p(i,j,k) << "\n";
+            });
+        }
+    };
+}
+
+Operator Isosurface (int comp, Real value, std::string prefix)
+{
+    return [=, prefix=std::move(prefix)] (Data const& d)
+    {
+        const Box& domain = d.geom.Domain();
+        const auto problo = d.geom.ProbLoArray();
+        const auto dx = d.geom.CellSizeArray();
+        Vector<Real> pts;
+        for (int K : d.mf.IndexArray()) {
+            const Box& vbx = d.mf.box(K);
+            auto const& a = d.mf.const_array(K, comp);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                // Each line is owned by the cell at its lower end.
+                Box b = vbx;
+                b.setBig(idim, std::min(vbx.bigEnd(idim), domain.bigEnd(idim)-1));
+                if (!b.ok()) { continue; }
+                const IntVect e = IntVect::TheDimensionVector(idim);
+                amrex::LoopOnCpu(b, [&] (int i, int j, int k) noexcept
+                {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+                    const Real f0 = a(iv) - value;
+                    const Real f1 = a(iv+e) - value;
+                    if ((f0 < 0 && f1 >= 0) || (f0 >= 0 && f1 < 0)) {
+                        const Real t = f0 / (f0 - f1);
+                        for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                            Real x = problo[n] + (iv[n]+Real(0.5))*dx[n];
+                            if (n == idim) { x += t*dx[n]; }
+                            pts.push_back(x);
+                        }
+                    }
+                });
+            }
+        }
+
+        Vector<Real> all_pts;
+#ifdef AMREX_USE_MPI
+        int nprocs;
+        MPI_Comm_size(d.comm, &nprocs);
+        const int cnt = static_cast<int>(pts.size());
+        std::vector<int> rcnt(nprocs, 0), disp(nprocs, 0);
+        MPI_Gather(&cnt, 1, MPI_INT, rcnt.data(), 1, MPI_INT, d.root, d.comm);
+        if (d.isRoot()) {
+            for (int i = 1; i < nprocs; ++i) { disp[i] = disp[i-1] + rcnt[i-1]; }
+            all_pts.resize(disp[nprocs-1] + rcnt[nprocs-1]);
+        }
+        MPI_Gatherv(pts.data(), cnt, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                    all_pts.data(), rcnt.data(), disp.data(),
+                    ParallelDescriptor::Mpi_typemap<Real>::type(), d.root, d.comm);
+#else
+        all_pts = std::move(pts);
+#endif
+
+        if (d.isRoot()) {
+            const std::string filename = product_name(prefix, d.step, ".txt");
+            std::ofstream ofs(filename);
+            if (!ofs.good()) { amrex::FileOpenFailed(filename); }
+            ofs.precision(std::numeric_limits<Real>::max_digits10);
+            ofs << "# " << d.varnames[comp] << " = " << value << " step " << d.step
+                << " time " << d.time << "\n";
+            for (Long i = 0; i < all_pts.size(); i += AMREX_SPACEDIM) {
+                for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                    ofs << all_pts[i+n] << ((n == AMREX_SPACEDIM-1) ? "\n" : " ");
+                }
+            }
+        }
+    };
+}
+
+Operator Downsample (int ratio, std::string prefix)
+{
+    AMREX_ALWAYS_ASSERT(ratio >= 1);
+    return [=, prefix=std::move(prefix)] (Data const& d)
+    {
+        AMREX_ALWAYS_ASSERT(d.geom.Domain().coarsenable(ratio));
+        const int ncomp = static_cast<int>(d.varnames.size());
+        const Box cdomain = amrex::coarsen(d.geom.Domain(), ratio);
+        const Real fac = Real(1.) / static_cast<Real>(AMREX_D_TERM(ratio,*ratio,*ratio));
+        FArrayBox fab(cdomain, ncomp, The_Cpu_Arena());
+        fab.setVal<RunOn::Host>(Real(0.));
+        auto const& c = fab.array();
+        for (int K : d.mf.IndexArray()) {
+            auto const& a = d.mf.const_array(K);
+            amrex::LoopOnCpu(d.mf.box(K), ncomp, [&] (int i, int j, int k, int n) noexcept
+            {
+                const IntVect civ = amrex::coarsen(IntVect(AMREX_D_DECL(i,j,k)), ratio);
+                c(civ,n) += fac * a(i,j,k,n);
+            });
+        }
+        ParallelReduce::Sum(fab.dataPtr(), static_cast<int>(fab.size()), d.root, d.comm);
+
+        if (d.isRoot()) {
+            const std::string filename = product_name(prefix, d.step, ".fab");
+            std::ofstream ofs(filename, std::ios::binary);
+            if (!ofs.good()) { amrex::FileOpenFailed(filename); }
+            fab.writeOn(ofs);
+        }
+    };
+}
+
+Pipeline::Pipeline (std::string const& pp_prefix)
+{
+    ParmParse pp(pp_prefix);
+    pp.query("int", m_interval);
+    pp.query("nranks", m_nranks);
+    pp.query("max_grid_size", m_max_grid_size);
+    pp.query("coarsen", m_coarsen);
+    pp.query("use_thread", m_use_thread);
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int myproc = ParallelDescriptor::MyProc();
+    m_nranks = std::clamp(m_nranks, 1, nprocs);
+    AMREX_ALWAYS_ASSERT(m_max_grid_size > 0 && m_coarsen >= 1);
+
+    // Spread the analysis ranks out, so that they are less likely to share a node.
+    for (int i = 0; i < m_nranks; ++i) {
+        m_ranks.push_back(static_cast<int>((Long(i)*nprocs)/m_nranks));
+    }
+    m_analysis_rank = std::find(m_ranks.begin(), m_ranks.end(), myproc) != m_ranks.end();
+
+#ifdef AMREX_USE_MPI
+    MPI_Comm_split(ParallelDescriptor::Communicator(),
+                   m_analysis_rank ? 0 : MPI_UNDEFINED, myproc, &m_comm);
+    if (m_analysis_rank) {
+        MPI_Comm_rank(m_comm, &m_rank);
+    }
+    if (m_use_thread && nprocs > 1) {
+        int provided = -1;
+        MPI_Query_thread(&provided);
+        if (provided < MPI_THREAD_MULTIPLE) {
+            amrex::Abort("InSitu::Pipeline with use_thread requires MPI_THREAD_MULTIPLE at "
+                         "runtime, but got " + ParallelDescriptor::mpi_level_to_string(provided));
+        }
+    }
+#else
+    m_rank = 0;
+#endif
+
+    if (m_use_thread && m_analysis_rank) {
+        m_thread = std::make_unique<BackgroundThread>();
+    }
+}
+
+Pipeline::~Pipeline ()
+{
+    finish();
+    m_thread.reset();
+#ifdef AMREX_USE_MPI
+    if (m_comm != MPI_COMM_NULL) { MPI_Comm_free(&m_comm); }
+#endif
+}
+
+void
+Pipeline::addOperator (std::string name, Operator op)
+{
+    m_ops.emplace_back(std::move(name), std::move(op));
+}
+
+void
+Pipeline::submit (MultiFab const& mf, Geometry const& geom,
+                  Vector<std::string> const& varnames, int step, Real time)
+{
+    if (m_interval <= 0 || step % m_interval != 0) { return; }
+
+    BL_PROFILE("InSitu::Pipeline::submit()");
+
+    if (m_copy_pending) { process(); }
+
+    const int ncomp = static_cast<int>(varnames.size());
+    AMREX_ALWAYS_ASSERT(mf.is_cell_centered() && ncomp > 0 && ncomp <= mf.nComp());
+
+    MultiFab const* src = &mf;
+    Geometry ageom = geom;
+    if (m_coarsen > 1) {
+        AMREX_ALWAYS_ASSERT(mf.boxArray().coarsenable(m_coarsen) &&
+                            geom.Domain().coarsenable(m_coarsen));
+        BoxArray cba = amrex::coarsen(mf.boxArray(), m_coarsen);
+        if (!m_crse || m_crse->nComp() != ncomp || m_crse->boxArray() != cba ||
+            m_crse->DistributionMap() != mf.DistributionMap())
+        {
+            m_crse = std::make_unique<MultiFab>(cba, mf.DistributionMap(), ncomp, 0);
+        }
+        amrex::average_down(mf, *m_crse, 0, ncomp, m_coarsen);
+        src = m_crse.get();
+        ageom = amrex::coarsen(geom, m_coarsen);
+    }
+
+    BoxArray aba(ageom.Domain());
+    aba.maxSize(m_max_grid_size);
+    if (!m_recv.mf || m_recv.mf->nComp() != ncomp || m_recv.mf->boxArray() != aba) {
+        Vector<int> pmap(aba.size());
+        for (int i = 0; i < static_cast<int>(pmap.size()); ++i) {
+            pmap[i] = m_ranks[i % m_nranks];
+        }
+        m_recv.mf = std::make_unique<MultiFab>(aba, DistributionMapping(std::move(pmap)),
+                                               ncomp, 1, MFInfo().SetArena(The_Pinned_Arena()));
+    }
+    m_recv.geom = ageom;
+    m_recv.varnames = varnames;
+    m_recv.step = step;
+    m_recv.time = time;
+
+    m_recv.mf->ParallelCopy_nowait(*src, 0, 0, ncomp, IntVect(0), IntVect(1),
+                                   ageom.periodicity());
+    m_copy_pending = true;
+}
+
+void
+Pipeline::process ()
+{
+    BL_PROFILE("InSitu::Pipeline::process()");
+
+    m_recv.mf->ParallelCopy_finish();
+    m_copy_pending = false;
+
+    // The previous analysis may still be using m_work.
+    if (m_thread) { m_thread->Finish(); }
+    std::swap(m_recv, m_work);
+
+    if (!m_analysis_rank || m_ops.empty()) { return; }
+
+    if (m_thread) {
+        m_thread->Submit([this] () { run(m_work); });
+    } else {
+        ParallelContext::push(m_comm);
+        run(m_work);
+        ParallelContext::pop();
+    }
+}
+
+void
+Pipeline::run (Snapshot const& s) const
+{
+    Data data{*s.mf, s.geom, s.varnames, s.step, s.time, m_comm, m_rank, 0};
+    for (auto const& op : m_ops) {
+        op.second(data);
+    }
+}
+
+void
+Pipeline::finish ()
+{
+    if (m_copy_pending) { process(); }
+    if (m_thread) { m_thread->Finish(); }
+}
+
+}
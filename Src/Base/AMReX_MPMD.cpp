@@ -220,6 +220,69 @@ Copier::Copier (BoxArray const& ba, DistributionMapping const& dm)
     }
 }
 
+
+void Copier::prepare_buffer (std::map<int,FabArrayBase::CopyComTagsContainer> const& tags,
+                             int ncomp, std::size_t value_size, std::size_t value_align,
+                             CommData& comm)
+{
+    comm.data.clear();
+    comm.size.clear();
+    comm.rank.clear();
+    comm.reqs.clear();
+    comm.cctc.clear();
+    comm.ncomp = ncomp;
+
+    Vector<std::size_t> offset;
+    std::size_t total_volume = 0;
+    for (auto const& kv : tags) {
+        std::size_t nbytes = 0;
+        for (auto const& cct : kv.second) {
+            nbytes += cct.sbox.numPts() * ncomp * value_size;
+        }
+
+        std::size_t acd = ParallelDescriptor::alignof_comm_data(nbytes);
+        nbytes = amrex::aligned_size(acd, nbytes); // so that nbytes are aligned
+
+        // Also need to align the offset properly
+        total_volume = amrex::aligned_size(std::max(value_align, acd), total_volume);
+
+        offset.push_back(total_volume);
+        total_volume += nbytes;
+
+        comm.data.push_back(nullptr);
+        comm.size.push_back(nbytes);
+        comm.rank.push_back(kv.first);
+        comm.reqs.push_back(MPI_REQUEST_NULL);
+        comm.cctc.push_back(&kv.second);
+    }
+
+    // The buffer only grows, so that repeated copies do not allocate.
+    // Clearing first avoids copying the old content when it does grow.
+    if (comm.buffer.size() < total_volume) {
+        comm.buffer.clear();
+        comm.buffer.resize(total_volume);
+    }
+    for (int i = 0, N = static_cast<int>(offset.size()); i < N; ++i) {
+        comm.data[i] = comm.buffer.data() + offset[i];
+    }
+}
+
+void Copier::wait (CommData& comm)
+{
+    if (!comm.reqs.empty()) {
+        Vector<MPI_Status> stats(comm.reqs.size());
+        ParallelDescriptor::Waitall(comm.reqs, stats);
+    }
+}
+
+void Copier::send_finish ()
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_send.active,
+                                     "MPMD::Copier::send_finish: no send_nowait");
+    wait(m_send);
+    m_send.active = false;
+}
+
 }
 
 #endif
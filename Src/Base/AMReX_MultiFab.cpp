@@ -52,12 +52,19 @@ MultiFab::Dot (const MultiFab& x, int xcomp, int numcomp, int nghost, bool local
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
         auto const& xma = x.const_arrays();
-        sm = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Real>{}, x, IntVect(nghost),
-        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept -> GpuTuple<Real>
+        AnyCTO(TypeList<detail::NCompOptions>{}, {detail::NCompOption(numcomp)},
+        [&] (auto cto_func) {
+            sm = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Real>{}, x, IntVect(nghost),
+                           cto_func);
+        },
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, auto nc_ctrl) noexcept
+            -> GpuTuple<Real>
         {
+            constexpr int NC = nc_ctrl.value;
+            const int nc = (NC > 0) ? NC : numcomp;
             Real t = Real(0.0);
             auto const& xfab = xma[box_no];
-            for (int n = 0; n < numcomp; ++n) {
+            for (int n = 0; n < nc; ++n) {
                 t += xfab(i,j,k,xcomp+n) * xfab(i,j,k,xcomp+n);
             }
             return t;
@@ -106,14 +113,21 @@ MultiFab::Dot (const iMultiFab& mask,
         auto const& xma = x.const_arrays();
         auto const& yma = y.const_arrays();
         auto const& mma = mask.const_arrays();
-        sm = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Real>{}, x, IntVect(nghost),
-        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept -> GpuTuple<Real>
+        AnyCTO(TypeList<detail::NCompOptions>{}, {detail::NCompOption(numcomp)},
+        [&] (auto cto_func) {
+            sm = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Real>{}, x, IntVect(nghost),
+                           cto_func);
+        },
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, auto nc_ctrl) noexcept
+            -> GpuTuple<Real>
         {
+            constexpr int NC = nc_ctrl.value;
+            const int nc = (NC > 0) ? NC : numcomp;
             Real t = Real(0.0);
             if (mma[box_no](i,j,k)) {
                 auto const& xfab = xma[box_no];
                 auto const& yfab = yma[box_no];
-                for (int n = 0; n < numcomp; ++n) {
+                for (int n = 0; n < nc; ++n) {
                     t += xfab(i,j,k,xcomp+n) * yfab(i,j,k,ycomp+n);
                 }
             }
@@ -355,11 +355,16 @@ namespace amrex
             auto const& crsema = crse_S_fine.arrays();
             auto const& finema = S_fine.const_arrays();
             auto const& finevolma = fvolume.const_arrays();
-            ParallelFor(crse_S_fine, IntVect(0), ncomp,
-            [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+            AnyCTO(TypeList<detail::NCompOptions>{}, {detail::NCompOption(ncomp)},
+            [&] (auto cto_func) { ParallelFor(crse_S_fine, IntVect(0), cto_func); },
+            [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, auto nc_ctrl) noexcept
             {
-                amrex_avgdown_with_vol(i,j,k,n,crsema[box_no],finema[box_no],finevolma[box_no],
-                                       0,scomp,ratio);
+                constexpr int NC = nc_ctrl.value;
+                const int nc = (NC > 0) ? NC : ncomp;
+                for (int n = 0; n < nc; ++n) {
+                    amrex_avgdown_with_vol(i,j,k,n,crsema[box_no],finema[box_no],
+                                           finevolma[box_no],0,scomp,ratio);
+                }
             });
             if (!Gpu::inNoSyncRegion()) {
                 Gpu::streamSynchronize();
@@ -1211,4 +1216,33 @@ namespace amrex
             FillRandomNormal(p, npts, mean, stddev);
         }
     }
+
+    void FillRandom (MultiFab& mf, int scomp, int ncomp, CounterRandom const& rng)
+    {
+        auto const& ma = mf.arrays();
+        ParallelFor(mf, mf.nGrowVect(), ncomp,
+        [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+        {
+            auto id = CounterRandom::cellId(IntVect(AMREX_D_DECL(i,j,k)));
+            ma[b](i,j,k,scomp+n) = rng.uniform(id, scomp+n);
+        });
+        if (!Gpu::inNoSyncRegion()) {
+            Gpu::streamSynchronize();
+        }
+    }
+
+    void FillRandomNormal (MultiFab& mf, int scomp, int ncomp, Real mean, Real stddev,
+                           CounterRandom const& rng)
+    {
+        auto const& ma = mf.arrays();
+        ParallelFor(mf, mf.nGrowVect(), ncomp,
+        [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+        {
+            auto id = CounterRandom::cellId(IntVect(AMREX_D_DECL(i,j,k)));
+            ma[b](i,j,k,scomp+n) = rng.normal(mean, stddev, id, scomp+n);
+        });
+        if (!Gpu::inNoSyncRegion()) {
+            Gpu::streamSynchronize();
+        }
+    }
 }
@@ -102,6 +102,23 @@ void PrepareCommBuffers(CommData& comm,
     }
 }
 
+void detail::FusedBufferView (Vector<char*>& data, Vector<std::size_t>& size,
+                              const CommData& comm, int comp_offset, int ncomp,
+                              std::size_t object_size)
+{
+    const auto N_comms = static_cast<int>(comm.data.size());
+    data.resize(N_comms);
+    size.resize(N_comms);
+    for (int i = 0; i < N_comms; ++i) {
+        std::size_t npts = 0;
+        for (auto const& cct : *comm.cctc[i]) {
+            npts += cct.sbox.numPts();
+        }
+        data[i] = comm.data[i] + npts * object_size * comp_offset;
+        size[i] = npts * object_size * ncomp;
+    }
+}
+
 void PostRecvs(CommData& recv, int mpi_tag) {
     AMREX_ASSERT(recv.data.size() == recv.offset.size());
     AMREX_ASSERT(recv.data.size() == recv.size.size());
@@ -242,6 +242,7 @@ void
 Message::wait ()
 {
     BL_PROFILE_S("ParallelDescriptor::Message::wait()");
+    BL_TINY_COMM_PROFILE_WAIT();
 
     BL_COMM_PROFILE(BLProfiler::Wait, sizeof(m_type), pid(), tag());
     BL_MPI_REQUIRE( MPI_Wait(&m_req, &m_stat) );
@@ -1076,6 +1077,7 @@ void
 Wait (MPI_Request& req, MPI_Status& status)
 {
     BL_PROFILE_S("ParallelDescriptor::Wait()");
+    BL_TINY_COMM_PROFILE_WAIT();
     BL_COMM_PROFILE_WAIT(BLProfiler::Wait, req, status, true);
     BL_MPI_REQUIRE( MPI_Wait(&req, &status) );
     BL_COMM_PROFILE_WAIT(BLProfiler::Wait, req, status, false);
@@ -1087,6 +1089,7 @@ Waitall (Vector<MPI_Request>& reqs, Vector<MPI_Status>& status)
     BL_ASSERT(status.size() >= reqs.size());
 
     BL_PROFILE_S("ParallelDescriptor::Waitall()");
+    BL_TINY_COMM_PROFILE_WAIT();
     BL_COMM_PROFILE_WAITSOME(BLProfiler::Waitall, reqs, reqs.size(), status, true);
     BL_MPI_REQUIRE( MPI_Waitall(reqs.size(),
                                 reqs.dataPtr(),
@@ -1098,6 +1101,7 @@ void
 Waitany (Vector<MPI_Request>& reqs, int &index, MPI_Status& status)
 {
     BL_PROFILE_S("ParallelDescriptor::Waitany()");
+    BL_TINY_COMM_PROFILE_WAIT();
     BL_COMM_PROFILE_WAIT(BLProfiler::Waitany, reqs[0], status, true);
     BL_MPI_REQUIRE( MPI_Waitany(reqs.size(),
                                 reqs.dataPtr(),
@@ -1114,6 +1118,7 @@ Waitsome (Vector<MPI_Request>& reqs, int& completed,
     BL_ASSERT(indx.size() >= reqs.size());
 
     BL_PROFILE_S("ParallelDescriptor::Waitsome()");
+    BL_TINY_COMM_PROFILE_WAIT();
     BL_COMM_PROFILE_WAITSOME(BLProfiler::Waitsome, reqs, reqs.size(), status, true);
     BL_MPI_REQUIRE( MPI_Waitsome(reqs.size(),
                                  reqs.dataPtr(),
@@ -1651,6 +1656,7 @@ Asend<char> (const char* buf, size_t n, int pid, int tag, MPI_Comm comm)
 {
     BL_PROFILE_T_S("ParallelDescriptor::Asend(TsiiM)", char);
     BL_COMM_PROFILE(BLProfiler::AsendTsiiM, n * sizeof(char), pid, tag);
+    BL_TINY_COMM_PROFILE_SEND(n * sizeof(char));
 
     MPI_Request req;
     Message msg;
@@ -1697,6 +1703,8 @@ Send<char> (const char* buf, size_t n, int pid, int tag, MPI_Comm comm)
 {
     BL_PROFILE_T_S("ParallelDescriptor::Send(Tsii)", char);
     BL_COMM_PROFILE(BLProfiler::SendTsii, n * sizeof(char), pid, tag);
+    BL_TINY_COMM_PROFILE_SEND(n * sizeof(char));
+    BL_TINY_COMM_PROFILE_WAIT();
 
     const int comm_data_type = ParallelDescriptor::select_comm_data_type(n);
     if (comm_data_type == 1) {
@@ -1738,6 +1746,7 @@ Arecv<char> (char* buf, size_t n, int pid, int tag, MPI_Comm comm)
 {
     BL_PROFILE_T_S("ParallelDescriptor::Arecv(TsiiM)", char);
     BL_COMM_PROFILE(BLProfiler::ArecvTsiiM, n * sizeof(char), pid, tag);
+    BL_TINY_COMM_PROFILE_RECV(n * sizeof(char));
 
     MPI_Request req;
     Message msg;
@@ -1782,6 +1791,8 @@ Recv<char> (char* buf, size_t n, int pid, int tag, MPI_Comm comm)
 {
     BL_PROFILE_T_S("ParallelDescriptor::Recv(Tsii)", char);
     BL_COMM_PROFILE(BLProfiler::RecvTsii, BLProfiler::BeforeCall(), pid, tag);
+    BL_TINY_COMM_PROFILE_RECV(n * sizeof(char));
+    BL_TINY_COMM_PROFILE_WAIT();
 
     MPI_Status stat;
     Message msg;
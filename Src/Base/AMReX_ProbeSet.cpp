@@ -0,0 +1,304 @@
+#include <AMReX_ProbeSet.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+namespace amrex {
+
+ProbeSet::ProbeSet (std::string filename, int scomp, Vector<std::string> varnames)
+    : m_filename(std::move(filename)),
+      m_scomp(scomp),
+      m_varnames(std::move(varnames))
+{
+    AMREX_ALWAYS_ASSERT(m_scomp >= 0 && !m_varnames.empty());
+}
+
+void
+ProbeSet::addPlane (std::string name, int dir, Real coord)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_defined, "ProbeSet: cannot add probes after the first write");
+    AMREX_ALWAYS_ASSERT(dir >= 0 && dir < AMREX_SPACEDIM);
+    RealVect loc(0.0);
+    loc[dir] = coord;
+    m_probes.push_back(Probe{std::move(name), Type::Plane, dir, loc, Box(), 0});
+}
+
+void
+ProbeSet::addLine (std::string name, int dir, RealVect const& loc)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_defined, "ProbeSet: cannot add probes after the first write");
+    AMREX_ALWAYS_ASSERT(dir >= 0 && dir < AMREX_SPACEDIM);
+    m_probes.push_back(Probe{std::move(name), Type::Line, dir, loc, Box(), 0});
+}
+
+void
+ProbeSet::addPoint (std::string name, RealVect const& loc)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_defined, "ProbeSet: cannot add probes after the first write");
+    m_probes.push_back(Probe{std::move(name), Type::Point, -1, loc, Box(), 0});
+}
+
+void
+ProbeSet::define (Vector<Geometry> const& geom, Vector<IntVect> const& ref_ratio)
+{
+    const int nlevs = static_cast<int>(geom.size());
+    m_geom = geom[nlevs-1];
+    m_ratio.resize(nlevs);
+    m_ratio[nlevs-1] = IntVect(1);
+    for (int lev = nlevs-2; lev >= 0; --lev) {
+        m_ratio[lev] = m_ratio[lev+1] * ref_ratio[lev];
+    }
+
+    const Box& domain = m_geom.Domain();
+    const auto ncomp = static_cast<Long>(m_varnames.size());
+    auto cell_of = [&] (RealVect const& x)
+    {
+        IntVect iv;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            iv[idim] = static_cast<int>(std::floor((x[idim] - m_geom.ProbLo(idim))
+                                                   * m_geom.InvCellSize(idim)));
+        }
+        return iv;
+    };
+
+    m_record_size = 0;
+    for (auto& p : m_probes) {
+        const IntVect iv = cell_of(p.loc);
+        p.box = domain;
+        if (p.type == Type::Plane) {
+            p.box.setRange(p.dir, iv[p.dir]);
+        } else {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (p.type == Type::Point || idim != p.dir) {
+                    p.box.setRange(idim, iv[idim]);
+                }
+            }
+        }
+        if (!domain.contains(p.box)) {
+            amrex::Abort("ProbeSet: probe " + p.name + " is outside the domain");
+        }
+        p.offset = m_record_size;
+        m_record_size += p.box.numPts() * ncomp;
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if (amrex::FileExists(m_filename)) {
+            // Appending after a restart.  Make sure the records match.
+            std::ifstream ifs(m_filename);
+            std::string magic;
+            Long nc = -1, np = -1, rs = -1;
+            ifs >> magic >> nc >> np >> rs;
+            if (magic != "AMReX-ProbeSet-V1" || nc != ncomp ||
+                np != static_cast<Long>(m_probes.size()) || rs != m_record_size) {
+                amrex::Abort("ProbeSet: existing file " + m_filename + " does not match the probes");
+            }
+        } else {
+            writeHeader();
+        }
+    }
+
+    m_defined = true;
+}
+
+void
+ProbeSet::writeHeader () const
+{
+    std::ofstream ofs(m_filename, std::ios::binary);
+    if (!ofs.good()) { amrex::FileOpenFailed(m_filename); }
+    ofs.precision(std::numeric_limits<Real>::max_digits10);
+    ofs << "AMReX-ProbeSet-V1\n"
+        << m_varnames.size() << " " << m_probes.size() << " " << m_record_size << "\n";
+    for (auto const& name : m_varnames) {
+        ofs << name << "\n";
+    }
+    const char* types[] = {"plane", "line", "point"};
+    for (auto const& p : m_probes) {
+        ofs << p.name << " " << types[static_cast<int>(p.type)] << " " << p.box;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            ofs << " " << m_geom.ProbLo(idim);
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            ofs << " " << m_geom.CellSize(idim);
+        }
+        ofs << "\n";
+    }
+    ofs << "end_header\n";
+}
+
+bool
+ProbeSet::planIsValid (Vector<MultiFab const*> const& mf) const
+{
+    if (!m_has_plan) { return false; }
+    const auto nlevs = std::min(mf.size(), m_ratio.size());
+    if (m_plan.ba.size() != nlevs) { return false; }
+    for (int lev = 0; lev < static_cast<int>(nlevs); ++lev) {
+        if (m_plan.ba[lev] != mf[lev]->boxArray() ||
+            m_plan.dm[lev] != mf[lev]->DistributionMap()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+ProbeSet::makePlan (Vector<MultiFab const*> const& mf)
+{
+    BL_PROFILE("ProbeSet::makePlan()");
+
+    m_plan = Plan{};
+    const int nlevs = static_cast<int>(std::min(mf.size(), m_ratio.size()));
+    for (int lev = 0; lev < nlevs; ++lev) {
+        m_plan.ba.push_back(mf[lev]->boxArray());
+        m_plan.dm.push_back(mf[lev]->DistributionMap());
+    }
+
+    // Each sample is owned by the finest level that covers it.  Because of
+    // proper nesting, it is enough to check the next finer level.
+    Vector<int> fabidx;
+    Vector<IntVect> cell;
+    for (int lev = 0; lev < nlevs; ++lev) {
+        const BoxArray& ba = mf[lev]->boxArray();
+        for (int gid : mf[lev]->IndexArray()) {
+            const Box& bx = amrex::refine(ba[gid], m_ratio[lev]);
+            bool used = false;
+            for (auto const& p : m_probes) {
+                const Box& b = bx & p.box;
+                if (!b.ok()) { continue; }
+                const Long stride = p.box.numPts();
+                amrex::LoopOnCpu(b, [&] (int i, int j, int k) noexcept
+                {
+                    amrex::ignore_unused(j,k);
+                    const IntVect s(AMREX_D_DECL(i,j,k));
+                    if (lev+1 < nlevs &&
+                        m_plan.ba[lev+1].contains(amrex::coarsen(s, m_ratio[lev+1]))) {
+                        return;
+                    }
+                    fabidx.push_back(static_cast<int>(m_plan.lev.size()));
+                    cell.push_back(amrex::coarsen(s, m_ratio[lev]));
+                    m_plan.offset.push_back(p.offset + p.box.index(s));
+                    m_plan.stride.push_back(stride);
+                    used = true;
+                });
+            }
+            if (used) {
+                m_plan.lev.push_back(lev);
+                m_plan.gid.push_back(gid);
+            }
+        }
+    }
+    m_plan.d_fab.resize(fabidx.size());
+    m_plan.d_cell.resize(cell.size());
+    Gpu::copyAsync(Gpu::hostToDevice, fabidx.begin(), fabidx.end(), m_plan.d_fab.begin());
+    Gpu::copyAsync(Gpu::hostToDevice, cell.begin(), cell.end(), m_plan.d_cell.begin());
+
+    // The I/O processor needs to know where everybody's samples go.
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const auto nlocal = static_cast<int>(m_plan.offset.size());
+    m_plan.rcnt = ParallelDescriptor::Gather(nlocal, ioproc);
+    m_plan.disp.resize(m_plan.rcnt.size(), 0);
+    Long ntotal = 0;
+    for (int i = 0; i < static_cast<int>(m_plan.rcnt.size()); ++i) {
+        m_plan.disp[i] = static_cast<int>(ntotal);
+        ntotal += m_plan.rcnt[i];
+    }
+    if (ParallelDescriptor::IOProcessor()) {
+        AMREX_ALWAYS_ASSERT(ntotal * static_cast<Long>(m_varnames.size()) == m_record_size);
+        m_plan.all_offset.resize(ntotal);
+        m_plan.all_stride.resize(ntotal);
+    }
+    ParallelDescriptor::Gatherv(m_plan.offset.data(), nlocal, m_plan.all_offset.data(),
+                                m_plan.rcnt, m_plan.disp, ioproc);
+    ParallelDescriptor::Gatherv(m_plan.stride.data(), nlocal, m_plan.all_stride.data(),
+                                m_plan.rcnt, m_plan.disp, ioproc);
+
+    Gpu::streamSynchronize();
+    m_has_plan = true;
+}
+
+void
+ProbeSet::write (MultiFab const& mf, Geometry const& geom, int step, Real time)
+{
+    write(Vector<MultiFab const*>{&mf}, Vector<Geometry>{geom}, Vector<IntVect>{}, step, time);
+}
+
+void
+ProbeSet::write (Vector<MultiFab const*> const& mf, Vector<Geometry> const& geom,
+                 Vector<IntVect> const& ref_ratio, int step, Real time)
+{
+    BL_PROFILE("ProbeSet::write()");
+
+    const int ncomp = static_cast<int>(m_varnames.size());
+    for (auto const* p : mf) {
+        AMREX_ALWAYS_ASSERT(p->is_cell_centered() && m_scomp + ncomp <= p->nComp());
+    }
+
+    if (!m_defined) { define(geom, ref_ratio); }
+    if (!planIsValid(mf)) { makePlan(mf); }
+
+    // Read the local samples
+    Vector<Array4<Real const>> h_arr;
+    for (int i = 0; i < static_cast<int>(m_plan.lev.size()); ++i) {
+        h_arr.push_back(mf[m_plan.lev[i]]->const_array(m_plan.gid[i], m_scomp));
+    }
+    Gpu::DeviceVector<Array4<Real const>> d_arr(h_arr.size());
+    Gpu::copyAsync(Gpu::hostToDevice, h_arr.begin(), h_arr.end(), d_arr.begin());
+
+    const auto nlocal = static_cast<int>(m_plan.offset.size());
+    Gpu::DeviceVector<Real> d_val(std::size_t(nlocal)*ncomp);
+    auto const* parr = d_arr.data();
+    auto const* pfab = m_plan.d_fab.data();
+    auto const* pcell = m_plan.d_cell.data();
+    auto* pval = d_val.data();
+    amrex::ParallelFor(nlocal, [=] AMREX_GPU_DEVICE (int i) noexcept
+    {
+        auto const& a = parr[pfab[i]];
+        for (int n = 0; n < ncomp; ++n) {
+            pval[i*ncomp+n] = a(pcell[i],n);
+        }
+    });
+    Gpu::HostVector<Real> h_val(d_val.size());
+    Gpu::copyAsync(Gpu::deviceToHost, d_val.begin(), d_val.end(), h_val.begin());
+    Gpu::streamSynchronize();
+
+    // Gather them on the I/O processor
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    std::vector<int> rcnt(m_plan.rcnt.size()), disp(m_plan.disp.size());
+    for (int i = 0; i < static_cast<int>(rcnt.size()); ++i) {
+        rcnt[i] = m_plan.rcnt[i] * ncomp;
+        disp[i] = m_plan.disp[i] * ncomp;
+    }
+    Vector<Real> all_val;
+    if (ParallelDescriptor::IOProcessor()) {
+        all_val.resize(m_record_size);
+    }
+    ParallelDescriptor::Gatherv(h_val.data(), nlocal*ncomp, all_val.data(), rcnt, disp, ioproc);
+
+    if (ParallelDescriptor::IOProcessor()) {
+        Vector<double> record(m_record_size);
+        for (Long i = 0, N = m_plan.all_offset.size(); i < N; ++i) {
+            for (int n = 0; n < ncomp; ++n) {
+                record[m_plan.all_offset[i] + n*m_plan.all_stride[i]] = all_val[i*ncomp+n];
+            }
+        }
+
+        std::ofstream ofs(m_filename, std::ios::binary | std::ios::app);
+        if (!ofs.good()) { amrex::FileOpenFailed(m_filename); }
+        const auto s = static_cast<std::int64_t>(step);
+        const auto t = static_cast<double>(time);
+        ofs.write(reinterpret_cast<char const*>(&s), sizeof(s));
+        ofs.write(reinterpret_cast<char const*>(&t), sizeof(t));
+        ofs.write(reinterpret_cast<char const*>(record.data()),
+                  static_cast<std::streamsize>(record.size()*sizeof(double)));
+        if (!ofs.good()) {
+            amrex::Error("ProbeSet::write: failed to write " + m_filename);
+        }
+    }
+}
+
+}
@@ -20,11 +20,23 @@
 #include <omp.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <thread>
 
 namespace amrex {
 
@@ -38,36 +50,111 @@ std::vector<std::string> TinyProfiler::all_memnames;
 std::vector<std::string>          TinyProfiler::regionstack;
 std::deque<std::tuple<double,double,std::string*> > TinyProfiler::ttstack;
 std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
+std::map<std::string, TinyProfiler::CommStat> TinyProfiler::commstats;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
 int TinyProfiler::device_synchronize_around_region = 0;
 int TinyProfiler::n_print_tabs = 0;
 int TinyProfiler::verbose = 0;
+int TinyProfiler::trace = 0;
+int TinyProfiler::summary = 1;
+int TinyProfiler::trace_buffer_size = 65536;
+std::string TinyProfiler::trace_file("tiny_profiler_trace");
+std::vector<std::unique_ptr<TinyProfiler::TraceBuffer>> TinyProfiler::trace_buffers;
+int TinyProfiler::trace_generation = 0;
+int TinyProfiler::perf_nevents = 0;
+std::vector<std::string> TinyProfiler::perf_names;
+std::vector<int> TinyProfiler::perf_fds;
+std::vector<int> TinyProfiler::perf_all_fds;
 
 namespace {
     constexpr char mainregion[] = "main";
+
+    // Thread that called Initialize.  Only its communication is recorded.
+    std::thread::id main_thread_id;
+
+    // Interned names of the timeline trace.  References to the elements
+    // of a deque stay valid when new names are appended.
+    std::mutex trace_mutex;
+    std::deque<std::string> trace_names;
+    std::unordered_map<std::string,int> trace_ids;
+
+    std::pair<int, std::string const*> intern_name (std::string const& name)
+    {
+        std::lock_guard<std::mutex> lock(trace_mutex);
+        auto it = trace_ids.find(name);
+        if (it == trace_ids.end()) {
+            it = trace_ids.emplace(name, static_cast<int>(trace_names.size())).first;
+            trace_names.push_back(name);
+        }
+        return std::make_pair(it->second, &trace_names[it->second]);
+    }
+
+    std::string json_escape (std::string const& s)
+    {
+        std::string r;
+        r.reserve(s.size());
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                r += '\\';
+                r += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                r += ' ';
+            } else {
+                r += c;
+            }
+        }
+        return r;
+    }
+
+#if defined(__linux__)
+    struct PerfEventType
+    {
+        const char* name;
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+    constexpr PerfEventType perf_event_types[] = {
+        {"cycles",           PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+        {"cache-misses",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {"branch-misses",    PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {"task-clock",       PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+        {"page-faults",      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+        {"context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}
+    };
+#endif
+
+    // Bytes transferred from memory per last level cache miss
+    constexpr double cache_line_size = 64.;
 }
 
 TinyProfiler::TinyProfiler (std::string funcname) noexcept
     : fname(std::move(funcname))
 {
+    if (trace) { trace_id = InternName(fname); }
     start();
 }
 
 TinyProfiler::TinyProfiler (std::string funcname, bool start_, bool useCUPTI) noexcept
     : fname(std::move(funcname)), uCUPTI(useCUPTI)
 {
+    if (trace) { trace_id = InternName(fname); }
     if (start_) { start(); }
 }
 
 TinyProfiler::TinyProfiler (const char* funcname) noexcept
     : fname(funcname)
 {
+    if (trace) { trace_id = InternName(funcname); }
     start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname, bool start_, bool useCUPTI) noexcept
     : fname(funcname), uCUPTI(useCUPTI)
 {
+    if (trace) { trace_id = InternName(funcname); }
     if (start_) { start(); }
 }
 
@@ -88,10 +175,12 @@ TinyProfiler::start () noexcept
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(stats.empty(), "TinyProfiler cannot be started twice");
     }
 
+    trace_start();
+
 #ifdef AMREX_USE_OMP
 #pragma omp master
 #endif
-    if (!regionstack.empty()) {
+    if (summary && !regionstack.empty()) {
 
 #ifdef AMREX_USE_CUPTI
         if (uCUPTI) {
@@ -130,6 +219,10 @@ TinyProfiler::start () noexcept
             stats.push_back(&st);
         }
 
+        if (perf_nevents > 0) {
+            PerfRead(perf_start);
+        }
+
         if (verbose) {
             ++n_print_tabs;
             std::string whitespace;
@@ -145,6 +238,7 @@ void
 TinyProfiler::stop () noexcept
 {
     memory_stop();
+    trace_stop();
 
 #ifdef AMREX_USE_OMP
 #pragma omp master
@@ -165,6 +259,11 @@ TinyProfiler::stop () noexcept
             t = amrex::second();
         }
 
+        std::array<Long,max_perf_events> perf_stop{};
+        if (perf_nevents > 0) {
+            PerfRead(perf_stop);
+        }
+
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(static_cast<int>(ttstack.size()) == global_depth,
             "TinyProfiler sections must be nested with respect to each other");
 #ifdef AMREX_USE_OMP
@@ -193,6 +292,9 @@ TinyProfiler::stop () noexcept
                 ++(st->n);
                 if (st->depth == 0) {
                     st->dtin += dtin;
+                    for (int i = 0; i < perf_nevents; ++i) {
+                        st->perf[i] += perf_stop[i] - perf_start[i];
+                    }
                 }
                 st->dtex += dtex;
                 st->usesCUPTI = uCUPTI;
@@ -238,6 +340,7 @@ void
 TinyProfiler::stop (unsigned boxUintID) noexcept
 {
     memory_stop();
+    trace_stop();
 
 #ifdef AMREX_USE_OMP
 #pragma omp master
@@ -312,6 +415,96 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
 }
 #endif
 
+int
+TinyProfiler::InternName (std::string const& name)
+{
+    TraceBuffer* buf = ThisTraceBuffer();
+    if (buf == nullptr) {
+        return intern_name(name).first;
+    }
+    auto it = buf->string_name_cache.find(name);
+    if (it != buf->string_name_cache.end()) {
+        return it->second;
+    } else {
+        int id = intern_name(name).first;
+        buf->string_name_cache.emplace(name, id);
+        return id;
+    }
+}
+
+int
+TinyProfiler::InternName (const char* name)
+{
+    // Names are usually string literals, whose addresses are looked up
+    // without locking in the cache of this thread.
+    TraceBuffer* buf = ThisTraceBuffer();
+    if (buf == nullptr) {
+        return intern_name(std::string(name)).first;
+    }
+    auto it = buf->name_cache.find(name);
+    if (it != buf->name_cache.end() && *(it->second.second) == name) {
+        return it->second.first;
+    } else {
+        auto r = intern_name(std::string(name));
+        buf->name_cache[name] = r;
+        return r.first;
+    }
+}
+
+TinyProfiler::TraceBuffer*
+TinyProfiler::ThisTraceBuffer () noexcept
+{
+    // omp_get_thread_num is not unique in nested parallel regions, so each
+    // thread keeps a pointer to its own buffer.  The buffer is set up at
+    // the first event of the thread, and again after Initialize has
+    // discarded the old ones.
+    thread_local TraceBuffer* buf = nullptr;
+    thread_local int buf_generation = -1;
+    if (buf_generation != trace_generation) {
+        buf = trace ? NewTraceBuffer() : nullptr;
+        buf_generation = trace_generation;
+    }
+    return buf;
+}
+
+TinyProfiler::TraceBuffer*
+TinyProfiler::NewTraceBuffer ()
+{
+    auto buf = std::make_unique<TraceBuffer>();
+    buf->events.resize(trace_buffer_size);
+    buf->open.reserve(64);
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_buffers.push_back(std::move(buf));
+    return trace_buffers.back().get();
+}
+
+void
+TinyProfiler::trace_start () const noexcept
+{
+    // Each thread only writes to its own buffer.  Once the buffer is full,
+    // the oldest events are overwritten.
+    if (trace_id < 0) { return; }
+    TraceBuffer* buf = ThisTraceBuffer();
+    if (buf) {
+        buf->open.push_back(this);
+        buf->events[buf->nevents % trace_buffer_size] = TraceEvent{amrex::second(), trace_id, true};
+        ++buf->nevents;
+    }
+}
+
+void
+TinyProfiler::trace_stop () const noexcept
+{
+    // it IS allowed to double stop a section
+    if (trace_id < 0) { return; }
+    TraceBuffer* buf = ThisTraceBuffer();
+    if (buf && !buf->open.empty() && buf->open.back() == this) {
+        buf->open.pop_back();
+        buf->events[buf->nevents % trace_buffer_size] = TraceEvent{amrex::second(), trace_id, false};
+        ++buf->nevents;
+    }
+}
+
 void
 TinyProfiler::memory_start () const noexcept {
     // multiple omp threads may share the same TinyProfiler object so this function must be const
@@ -388,12 +581,22 @@ TinyProfiler::Initialize () noexcept
 {
     regionstack.emplace_back(mainregion);
     t_init = amrex::second();
+    main_thread_id = std::this_thread::get_id();
     {
         amrex::ParmParse pp("tiny_profiler");
         pp.queryAdd("device_synchronize_around_region", device_synchronize_around_region);
         pp.queryAdd("verbose", verbose);
         pp.queryAdd("v", verbose);
+        pp.queryAdd("trace", trace);
+        pp.queryAdd("summary", summary);
+        pp.queryAdd("trace_buffer_size", trace_buffer_size);
+        pp.queryAdd("trace_file", trace_file);
+        pp.queryAdd("perf_events", perf_names);
     }
+    PerfInitialize();
+    trace_buffer_size = std::max(trace_buffer_size, 2);
+    trace_buffers.clear();
+    ++trace_generation;
 }
 
 void
@@ -420,6 +623,7 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
 
     // make a local copy so that any functions call after this will not be recorded in the local copy.
     auto lstatsmap = statsmap;
+    auto lcommstats = commstats;
 
     int nprocs = ParallelDescriptor::NProcs();
     int ioproc = ParallelDescriptor::IOProcessorNumber();
@@ -468,6 +672,347 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    PrintCommStats(lcommstats);
+
+    if (trace) {
+        WriteTrace(t_final);
+    }
+
+    if (!bFlushing) {
+        PerfFinalize();
+    }
+}
+
+void
+TinyProfiler::PerfInitialize ()
+{
+    if (perf_names.empty()) { return; }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(static_cast<int>(perf_names.size()) <= max_perf_events,
+                                     "TinyProfiler: too many tiny_profiler.perf_events");
+
+#if defined(__linux__)
+    std::vector<perf_event_attr> attrs(perf_names.size());
+    for (std::size_t i = 0; i < perf_names.size(); ++i) {
+        auto it = std::find_if(std::begin(perf_event_types), std::end(perf_event_types),
+                               [&] (PerfEventType const& pet) { return perf_names[i] == pet.name; });
+        if (it == std::end(perf_event_types)) {
+            amrex::Abort("TinyProfiler: unknown tiny_profiler.perf_events " + perf_names[i]);
+        }
+        std::memset(&attrs[i], 0, sizeof(perf_event_attr));
+        attrs[i].size = sizeof(perf_event_attr);
+        attrs[i].type = it->type;
+        attrs[i].config = it->config;
+        attrs[i].read_format = PERF_FORMAT_GROUP;
+        attrs[i].exclude_kernel = 1;
+        attrs[i].exclude_hv = 1;
+    }
+
+    // Each thread opens a group of counters for itself.  The groups are
+    // read by the master thread, so that the counts of a section include
+    // the work done by all threads.
+#ifdef AMREX_USE_OMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    perf_fds.assign(nthreads, -1);
+    bool ok = true;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+    {
+#ifdef AMREX_USE_OMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+        std::vector<int> fds;
+        int leader = -1;
+        for (auto& attr : attrs) {
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) { break; }
+            if (leader < 0) { leader = fd; }
+            fds.push_back(fd);
+        }
+#ifdef AMREX_USE_OMP
+#pragma omp critical (amrex_tiny_profiler_perf)
+#endif
+        {
+            ok = ok && (fds.size() == attrs.size());
+            perf_fds[tid] = leader;
+            perf_all_fds.insert(perf_all_fds.end(), fds.begin(), fds.end());
+        }
+    }
+
+    // The set of counters must be the same on all processes.
+    ParallelDescriptor::ReduceBoolAnd(ok);
+    if (ok) {
+        perf_nevents = static_cast<int>(perf_names.size());
+    } else {
+        PerfFinalize();
+        amrex::Print() << "TinyProfiler: perf_event_open failed for tiny_profiler.perf_events;"
+                       << " hardware counters are disabled\n";
+    }
+#else
+    amrex::Print() << "TinyProfiler: tiny_profiler.perf_events is only supported on Linux\n";
+#endif
+}
+
+void
+TinyProfiler::PerfFinalize ()
+{
+#if defined(__linux__)
+    for (int fd : perf_all_fds) {
+        ::close(fd);
+    }
+#endif
+    perf_all_fds.clear();
+    perf_fds.clear();
+    perf_nevents = 0;
+}
+
+void
+TinyProfiler::PerfRead (std::array<Long,max_perf_events>& counts) noexcept
+{
+    counts.fill(0);
+#if defined(__linux__)
+    // PERF_FORMAT_GROUP: the number of events followed by their values
+    std::array<std::uint64_t,max_perf_events+1> buf{};
+    const auto nbytes = static_cast<ssize_t>(sizeof(std::uint64_t)*(perf_nevents+1));
+    for (int fd : perf_fds) {
+        if (::read(fd, buf.data(), nbytes) == nbytes) {
+            for (int i = 0; i < perf_nevents; ++i) {
+                counts[i] += static_cast<Long>(buf[i+1]);
+            }
+        }
+    }
+#endif
+}
+
+void
+TinyProfiler::PrintPerfStats (std::map<std::string,Stats> const& regstats)
+{
+    // The set of profiled functions has been synced by PrintStats.
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    auto find_event = [] (std::string const& name) {
+        auto it = std::find(perf_names.begin(), perf_names.end(), name);
+        return (it == perf_names.end()) ? -1 : static_cast<int>(it-perf_names.begin());
+    };
+    const int icycles = find_event("cycles");
+    const int iinstrs = find_event("instructions");
+    const int imisses = find_event("cache-misses");
+    const bool has_ipc = icycles >= 0 && iinstrs >= 0;
+    const bool has_bw = imisses >= 0;
+
+    struct PerfProcStats
+    {
+        std::array<double,max_perf_events> avg{};
+        double ipcmin = std::numeric_limits<double>::max(), ipcavg = 0., ipcmax = 0.;
+        double bwmin = std::numeric_limits<double>::max(), bwavg = 0., bwmax = 0.;
+        double dtinmax = 0.;
+        std::string fname;
+    };
+
+    std::vector<PerfProcStats> allprocstats;
+
+    const int nv = perf_nevents+1;
+    for (auto const& regstat : regstats)
+    {
+        std::vector<double> lv(nv);
+        for (int i = 0; i < perf_nevents; ++i) {
+            lv[i] = static_cast<double>(regstat.second.perf[i]);
+        }
+        lv[perf_nevents] = regstat.second.dtin;
+
+        std::vector<double> gv(nv*nprocs);
+        if (nprocs == 1) {
+            gv = lv;
+        } else {
+            ParallelDescriptor::Gather(lv.data(), nv, gv.data(), nv, ioproc);
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+            PerfProcStats pst;
+            for (int ip = 0; ip < nprocs; ++ip) {
+                double const* v = gv.data() + ip*nv;
+                double dtin = v[perf_nevents];
+                for (int i = 0; i < perf_nevents; ++i) {
+                    pst.avg[i] += v[i];
+                }
+                if (has_ipc) {
+                    double ipc = (v[icycles] > 0.) ? v[iinstrs]/v[icycles] : 0.;
+                    pst.ipcmin = std::min(pst.ipcmin, ipc);
+                    pst.ipcavg += ipc;
+                    pst.ipcmax = std::max(pst.ipcmax, ipc);
+                }
+                if (has_bw) {
+                    double bw = (dtin > 0.) ? v[imisses]*cache_line_size/dtin*1.e-9 : 0.;
+                    pst.bwmin = std::min(pst.bwmin, bw);
+                    pst.bwavg += bw;
+                    pst.bwmax = std::max(pst.bwmax, bw);
+                }
+                pst.dtinmax = std::max(pst.dtinmax, dtin);
+            }
+            for (int i = 0; i < perf_nevents; ++i) {
+                pst.avg[i] /= nprocs;
+            }
+            pst.ipcavg /= nprocs;
+            pst.bwavg /= nprocs;
+            pst.fname = regstat.first;
+            allprocstats.push_back(pst);
+        }
+    }
+
+    if (!ParallelDescriptor::IOProcessor()) { return; }
+
+    std::sort(allprocstats.begin(), allprocstats.end(),
+              [] (PerfProcStats const& lhs, PerfProcStats const& rhs) {
+                  return lhs.dtinmax > rhs.dtinmax;
+              });
+
+    auto to_string = [] (double x) {
+        std::ostringstream ss;
+        ss << std::setprecision(4) << x;
+        return ss.str();
+    };
+
+    std::vector<std::vector<std::string>> allstatsstr;
+    {
+        std::vector<std::string> header{"Name"};
+        for (auto const& name : perf_names) {
+            header.push_back(name);
+        }
+        if (has_ipc) {
+            header.insert(header.end(), {"IPC Min", "IPC Avg", "IPC Max"});
+        }
+        if (has_bw) {
+            header.insert(header.end(), {"GB/s Min", "GB/s Avg", "GB/s Max"});
+        }
+        allstatsstr.push_back(std::move(header));
+    }
+
+    for (auto const& stat : allprocstats) {
+        bool nonzero = false;
+        std::vector<std::string> row{stat.fname};
+        for (int i = 0; i < perf_nevents; ++i) {
+            row.push_back(to_string(stat.avg[i]));
+            nonzero = nonzero || stat.avg[i] > 0.;
+        }
+        if (has_ipc) {
+            row.insert(row.end(), {to_string(stat.ipcmin), to_string(stat.ipcavg),
+                                   to_string(stat.ipcmax)});
+        }
+        if (has_bw) {
+            row.insert(row.end(), {to_string(stat.bwmin), to_string(stat.bwavg),
+                                   to_string(stat.bwmax)});
+        }
+        if (nonzero) {
+            allstatsstr.push_back(std::move(row));
+        }
+    }
+
+    if (allstatsstr.size() == 1) { return; }
+
+    std::vector<int> maxlen(allstatsstr[0].size(), 0);
+    for (auto& strvec : allstatsstr) {
+        for (std::size_t i=0; i<maxlen.size(); ++i) {
+            maxlen[i] = std::max(maxlen[i], static_cast<int>(strvec[i].size()));
+        }
+    }
+
+    for (std::size_t i=1; i<maxlen.size(); ++i) {
+        maxlen[i] += 2;
+    }
+
+    int lenhline = 0;
+    for (auto i : maxlen) {
+        lenhline += i;
+    }
+    const std::string hline(lenhline, '-');
+
+    amrex::OutStream() << "Hardware counters (inclusive, average over processes):\n";
+    amrex::OutStream() << hline << "\n";
+    for (std::size_t i=0; i<allstatsstr.size(); ++i) {
+        amrex::OutStream() << std::left << std::setw(maxlen[0]) << allstatsstr[i][0];
+        for (std::size_t j=1; j<maxlen.size(); ++j) {
+            amrex::OutStream() << std::right << std::setw(maxlen[j]) << allstatsstr[i][j];
+        }
+        amrex::OutStream() << '\n';
+        if (i==0) {
+            amrex::OutStream() << hline << "\n";
+        }
+    }
+    amrex::OutStream() << hline << "\n\n";
+}
+
+void
+TinyProfiler::WriteTrace (double t_final)
+{
+    const int myproc = ParallelDescriptor::MyProc();
+    const std::string filename = trace_file + "." + std::to_string(myproc) + ".json";
+
+    std::ofstream ofs(filename);
+    if (!ofs.good()) {
+        amrex::FileOpenFailed(filename);
+    }
+
+    // Chrome trace event format, which can be viewed with Perfetto
+    // (ui.perfetto.dev) or chrome://tracing.  Time stamps are in
+    // microseconds since TinyProfiler::Initialize.
+    ofs << std::fixed << std::setprecision(3);
+    ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << myproc
+        << ",\"args\":{\"name\":\"rank " << myproc << "\"}}";
+
+    Long ndropped = 0;
+    for (int tid = 0; tid < static_cast<int>(trace_buffers.size()); ++tid)
+    {
+        auto const& buf = *trace_buffers[tid];
+        const Long nevents = buf.nevents;
+        const Long first = std::max(Long(0), nevents - Long(trace_buffer_size));
+        ndropped += first;
+
+        auto write_event = [&] (int id, double tbegin, double tend)
+        {
+            ofs << ",\n{\"name\":\"" << json_escape(trace_names[id])
+                << "\",\"ph\":\"X\",\"pid\":" << myproc << ",\"tid\":" << tid
+                << ",\"ts\":" << (tbegin-t_init)*1.e6
+                << ",\"dur\":" << (tend-tbegin)*1.e6 << "}";
+        };
+
+        // Match the starts and stops.  Stops whose starts have been
+        // overwritten are skipped, and sections still running are closed
+        // at t_final.
+        std::vector<std::pair<int,double>> started;
+        for (Long ie = first; ie < nevents; ++ie) {
+            TraceEvent const& ev = buf.events[ie % trace_buffer_size];
+            if (ev.begin) {
+                started.emplace_back(ev.id, ev.t);
+            } else if (!started.empty() && started.back().first == ev.id) {
+                write_event(ev.id, started.back().second, ev.t);
+                started.pop_back();
+            }
+        }
+        while (!started.empty()) {
+            write_event(started.back().first, started.back().second, t_final);
+            started.pop_back();
+        }
+    }
+
+    ofs << "\n]}\n";
+
+    ParallelReduce::Sum(ndropped, ParallelDescriptor::IOProcessorNumber(),
+                        ParallelDescriptor::Communicator());
+    amrex::Print() << "TinyProfiler trace written to " << trace_file << ".*.json";
+    if (ndropped > 0) {
+        amrex::Print() << " (" << ndropped << " oldest events overwritten; increase"
+                       << " tiny_profiler.trace_buffer_size to keep them)";
+    }
+    amrex::Print() << "\n";
 }
 
 void
@@ -715,6 +1260,10 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
         amrex::OutStream() << hline << "\n";
         amrex::OutStream() << std::endl;
     }
+
+    if (perf_nevents > 0) {
+        PrintPerfStats(regstats);
+    }
 }
 
 void
@@ -887,6 +1436,218 @@ TinyProfiler::PrintMemStats(std::map<std::string, MemStat>& memstats,
     amrex::OutStream() << hline << "\n\n";
 }
 
+TinyProfiler::CommStat*
+TinyProfiler::ThisCommStat () noexcept
+{
+    // Communication is attributed to the innermost section of the master
+    // thread.  Other threads (e.g., OpenMP workers, the AsyncOut and InSitu
+    // threads) do not touch ttstack and commstats.
+#ifdef AMREX_USE_OMP
+    if (omp_get_thread_num() != 0) { return nullptr; }
+#endif
+    if (std::this_thread::get_id() != main_thread_id) { return nullptr; }
+    if (ttstack.empty()) {
+        return &commstats["Unprofiled"];
+    } else {
+        return &commstats[*std::get<2>(ttstack.back())];
+    }
+}
+
+void
+TinyProfiler::CommSend (Long nbytes) noexcept
+{
+    if (CommStat* cs = ThisCommStat()) {
+        ++cs->nsend;
+        cs->bytes_sent += nbytes;
+    }
+}
+
+void
+TinyProfiler::CommRecv (Long nbytes) noexcept
+{
+    if (CommStat* cs = ThisCommStat()) {
+        ++cs->nrecv;
+        cs->bytes_recv += nbytes;
+    }
+}
+
+void
+TinyProfiler::CommWait (double dt, bool reduction) noexcept
+{
+    if (CommStat* cs = ThisCommStat()) {
+        cs->dtwait += dt;
+        if (reduction) { ++cs->nreduce; }
+    }
+}
+
+void
+TinyProfiler::PrintCommStats (std::map<std::string, CommStat>& cstats)
+{
+    // make sure the set of profiled functions is the same on all processes
+    {
+        Vector<std::string> localStrings, syncedStrings;
+        bool alreadySynced;
+
+        for(auto const& kv : cstats) {
+            localStrings.push_back(kv.first);
+        }
+
+        amrex::SyncStrings(localStrings, syncedStrings, alreadySynced);
+
+        if (! alreadySynced) {  // add the new name
+            for (auto const& s : syncedStrings) {
+                if (cstats.find(s) == cstats.end()) {
+                    cstats[s]; // insert
+                }
+            }
+        }
+    }
+
+    if (cstats.empty()) { return; }
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    struct CommProcStats
+    {
+        Long nmsgs_avg = 0, nmsgs_max = 0;
+        Long bytes_avg = 0, bytes_max = 0;
+        Long nreduce_max = 0;
+        double dtwait_min = std::numeric_limits<double>::max();
+        double dtwait_avg = 0., dtwait_max = 0.;
+        std::string fname;
+    };
+
+    std::vector<CommProcStats> allprocstats;
+
+    // now collect global data onto the ioproc
+    for (const auto & it : cstats)
+    {
+        Long ls[3] = {it.second.nsend + it.second.nrecv,
+                      it.second.bytes_sent + it.second.bytes_recv,
+                      it.second.nreduce};
+        double dtwait = it.second.dtwait;
+
+        std::vector<Long> ls_vec(3*nprocs);
+        std::vector<double> dtwait_vec(nprocs);
+
+        if (nprocs == 1)
+        {
+            std::copy(ls, ls+3, ls_vec.begin());
+            dtwait_vec[0] = dtwait;
+        } else
+        {
+            ParallelDescriptor::Gather(ls, 3, ls_vec.data(), 3, ioproc);
+            ParallelDescriptor::Gather(&dtwait, 1, dtwait_vec.data(), 1, ioproc);
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+            CommProcStats pst;
+            for (int i = 0; i < nprocs; ++i) {
+                pst.nmsgs_avg += ls_vec[3*i];
+                pst.nmsgs_max = std::max(pst.nmsgs_max, ls_vec[3*i]);
+                pst.bytes_avg += ls_vec[3*i+1];
+                pst.bytes_max = std::max(pst.bytes_max, ls_vec[3*i+1]);
+                pst.nreduce_max = std::max(pst.nreduce_max, ls_vec[3*i+2]);
+                pst.dtwait_min = std::min(pst.dtwait_min, dtwait_vec[i]);
+                pst.dtwait_avg += dtwait_vec[i];
+                pst.dtwait_max = std::max(pst.dtwait_max, dtwait_vec[i]);
+            }
+            pst.nmsgs_avg /= nprocs;
+            pst.bytes_avg /= nprocs;
+            pst.dtwait_avg /= nprocs;
+            pst.fname = it.first;
+            allprocstats.push_back(pst);
+        }
+    }
+
+    if (!ParallelDescriptor::IOProcessor()) { return; }
+
+    std::sort(allprocstats.begin(), allprocstats.end(),
+              [] (CommProcStats const& lhs, CommProcStats const& rhs) {
+                  return lhs.dtwait_max > rhs.dtwait_max;
+              });
+
+    std::vector<std::vector<std::string>> allstatsstr;
+    allstatsstr.push_back({"Name", "NMsgs Avg", "NMsgs Max", "Bytes Avg", "Bytes Max",
+                           "NReduce", "Wait Min", "Wait Avg", "Wait Max"});
+
+    auto mem_to_string = [] (Long nbytes) {
+        std::string unit = "   B";
+        if (nbytes >= 10000) {
+            nbytes /= 1024;
+            unit = " KiB";
+        }
+        if (nbytes >= 10000) {
+            nbytes /= 1024;
+            unit = " MiB";
+        }
+        if (nbytes >= 10000) {
+            nbytes /= 1024;
+            unit = " GiB";
+        }
+        if (nbytes >= 10000) {
+            nbytes /= 1024;
+            unit = " TiB";
+        }
+        return std::to_string(nbytes) + unit;
+    };
+
+    auto time_to_string = [] (double t) {
+        std::ostringstream ss;
+        ss << std::setprecision(4) << t;
+        return ss.str();
+    };
+
+    for (auto& stat : allprocstats) {
+        if (stat.nmsgs_max != 0 || stat.nreduce_max != 0 || stat.dtwait_max > 0.) {
+            allstatsstr.push_back({stat.fname,
+                                   std::to_string(stat.nmsgs_avg),
+                                   std::to_string(stat.nmsgs_max),
+                                   mem_to_string(stat.bytes_avg),
+                                   mem_to_string(stat.bytes_max),
+                                   std::to_string(stat.nreduce_max),
+                                   time_to_string(stat.dtwait_min),
+                                   time_to_string(stat.dtwait_avg),
+                                   time_to_string(stat.dtwait_max)});
+        }
+    }
+
+    if (allstatsstr.size() == 1) { return; }
+
+    std::vector<int> maxlen(allstatsstr[0].size(), 0);
+    for (auto& strvec : allstatsstr) {
+        for (std::size_t i=0; i<maxlen.size(); ++i) {
+            maxlen[i] = std::max(maxlen[i], static_cast<int>(strvec[i].size()));
+        }
+    }
+
+    for (std::size_t i=1; i<maxlen.size(); ++i) {
+        maxlen[i] += 2;
+    }
+
+    int lenhline = 0;
+    for (auto i : maxlen) {
+        lenhline += i;
+    }
+    const std::string hline(lenhline, '-');
+
+    amrex::OutStream() << "Communication (messages and bytes sent and received, "
+                       << "time in MPI waits and reductions):\n";
+    amrex::OutStream() << hline << "\n";
+    for (std::size_t i=0; i<allstatsstr.size(); ++i) {
+        amrex::OutStream() << std::left << std::setw(maxlen[0]) << allstatsstr[i][0];
+        for (std::size_t j=1; j<maxlen.size(); ++j) {
+            amrex::OutStream() << std::right << std::setw(maxlen[j]) << allstatsstr[i][j];
+        }
+        amrex::OutStream() << '\n';
+        if (i==0) {
+            amrex::OutStream() << hline << "\n";
+        }
+    }
+    amrex::OutStream() << hline << "\n\n";
+}
+
 void
 TinyProfiler::StartRegion (std::string regname) noexcept
 {
@@ -925,6 +1686,15 @@ TinyProfileRegion::~TinyProfileRegion ()
     TinyProfiler::StopRegion(regname);
 }
 
+TinyProfileCommWait::TinyProfileCommWait (bool a_reduction) noexcept
+    : t_start(amrex::second()), reduction(a_reduction)
+{}
+
+TinyProfileCommWait::~TinyProfileCommWait ()
+{
+    TinyProfiler::CommWait(amrex::second()-t_start, reduction);
+}
+
 void
 TinyProfiler::PrintCallStack (std::ostream& os)
 {
@@ -231,12 +231,24 @@ Build (const Geometry& geom, int required_coarsening_level,
     }
 }
 
-void addFineLevels (int num_new_fine_levels)
+void addFineLevels (int num_new_fine_levels, bool build_on_demand)
 {
     BL_PROFILE("EB2::addFineLevels()");
     auto *p = const_cast<IndexSpace*>(TopIndexSpace());
     if (p) {
-        p->addFineLevels(num_new_fine_levels);
+        if (build_on_demand) {
+            p->addFineLevelsOnDemand(num_new_fine_levels);
+        } else {
+            p->addFineLevels(num_new_fine_levels);
+        }
+    }
+}
+
+void extendLevel (const Geometry& geom, const BoxArray& ba, int ngrow)
+{
+    auto *p = const_cast<IndexSpace*>(TopIndexSpace());
+    if (p) {
+        p->extendLevel(geom, ba, ngrow);
     }
 }
 
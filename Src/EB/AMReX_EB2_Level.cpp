@@ -927,13 +927,14 @@ Level::fillCutCellMask (iMultiFab& cutcellmask, const Geometry&) const
 }
 
 void
-Level::write_to_chkpt_file (const std::string& fname, bool extend_domain_face, int max_grid_size) const
+Level::write_to_chkpt_file (const std::string& fname, bool extend_domain_face, int max_grid_size,
+                            bool compact) const
 {
     ChkptFile chkptFile(fname);
     chkptFile.write_to_chkpt_file(m_grids, m_covered_grids,
                                   m_volfrac, m_centroid, m_bndryarea, m_bndrycent,
                                   m_bndrynorm, m_areafrac, m_facecent, m_edgecent, m_levelset,
-                                  m_geom, m_ngrow, extend_domain_face, max_grid_size);
+                                  m_geom, m_ngrow, extend_domain_face, max_grid_size, compact);
 }
 
 void
@@ -1017,4 +1018,128 @@ Level::buildCutCellMask (Level const& fine_level)
     }
 }
 
+
+BoxList
+Level::unbuiltRegion (const BoxArray& ba, int ngrow) const
+{
+    const int blk = onDemandBlockingFactor();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_geom.Domain().coarsenable(blk),
+                                     "EB2::Level: on-demand level domain must be coarsenable by 8");
+
+    const Box& domain = m_geom.Domain();
+    const std::vector<IntVect>& pshifts = m_geom.periodicity().shiftIntVect();
+
+    // Blocks touched by ba, including the periodic images of the parts
+    // of grown boxes outside periodic boundaries.
+    BoxList bl;
+    const int nboxes = int(ba.size());
+    for (int ibox = 0; ibox < nboxes; ++ibox) {
+        const Box& b = amrex::grow(amrex::enclosedCells(ba[ibox]), ngrow);
+        for (const auto& iv : pshifts) {
+            const Box& pb = (b+iv) & domain;
+            if (pb.ok()) {
+                bl.push_back(amrex::coarsen(pb, blk));
+            }
+        }
+    }
+    if (bl.isEmpty()) { return bl; }
+
+    bl = amrex::removeOverlap(bl);
+
+    BoxList r;
+    if (m_built_blocks.empty()) {
+        r = std::move(bl);
+    } else {
+        for (const Box& b : bl) {
+            BoxList diff;
+            diff.complementIn(b, m_built_blocks);
+            r.join(diff);
+        }
+    }
+    r.simplify();
+    r.refine(blk);
+    return r;
+}
+
+void
+Level::addPatch (Level const& patch, BoxList const& region)
+{
+    BL_PROFILE("EB2::Level::addPatch()");
+
+    AMREX_ASSERT(m_on_demand);
+
+    m_ngrow = patch.m_ngrow;
+
+    {
+        BoxList bl(m_built_blocks);
+        bl.join(amrex::coarsen(region, onDemandBlockingFactor()));
+        bl.simplify();
+        m_built_blocks = BoxArray(std::move(bl));
+    }
+
+    if (!patch.m_covered_grids.empty()) {
+        BoxList bl(m_covered_grids);
+        bl.join(BoxList(patch.m_covered_grids));
+        m_covered_grids = BoxArray(std::move(bl));
+    }
+
+    if (!patch.m_grids.empty() || m_grids.empty())
+    {
+        // The boxes already here keep their owners, so the old and the
+        // new data are both local to the new fabs.
+        const int nold = int(m_grids.size());
+        BoxList bl(m_grids);
+        Vector<int> pmap = m_dmap.ProcessorMap();
+        if (!patch.m_grids.empty()) {
+            bl.join(BoxList(patch.m_grids));
+            pmap.insert(pmap.end(), patch.m_dmap.ProcessorMap().begin(),
+                        patch.m_dmap.ProcessorMap().end());
+        }
+        BoxArray grids(std::move(bl));
+        DistributionMapping dmap(std::move(pmap));
+
+        MFInfo mf_info;
+        mf_info.SetTag("EB2::Level");
+        const int ng = GFab::ng;
+
+        auto merge = [&] (auto& fa, auto const& patch_fa, IntVect const& typ, int ncomp)
+        {
+            using FA = std::decay_t<decltype(fa)>;
+            FA new_fa(amrex::convert(grids,typ), dmap, ncomp, ng, mf_info);
+            for (MFIter mfi(new_fa); mfi.isValid(); ++mfi) {
+                const int i = mfi.index();
+                auto& dfab = new_fa[mfi];
+                if (i < nold) {
+                    dfab.template copy<RunOn::Device>(fa[i]);
+                } else {
+                    dfab.template copy<RunOn::Device>(patch_fa[i-nold]);
+                }
+            }
+            fa = std::move(new_fa);
+        };
+
+        merge(m_levelset, patch.m_levelset, IntVect::TheNodeVector(), 1);
+        merge(m_cellflag, patch.m_cellflag, IntVect::TheCellVector(), 1);
+        merge(m_volfrac, patch.m_volfrac, IntVect::TheCellVector(), 1);
+        merge(m_centroid, patch.m_centroid, IntVect::TheCellVector(), AMREX_SPACEDIM);
+        merge(m_bndryarea, patch.m_bndryarea, IntVect::TheCellVector(), 1);
+        merge(m_bndrycent, patch.m_bndrycent, IntVect::TheCellVector(), AMREX_SPACEDIM);
+        merge(m_bndrynorm, patch.m_bndrynorm, IntVect::TheCellVector(), AMREX_SPACEDIM);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            merge(m_areafrac[idim], patch.m_areafrac[idim],
+                  IntVect::TheDimensionVector(idim), 1);
+            merge(m_facecent[idim], patch.m_facecent[idim],
+                  IntVect::TheDimensionVector(idim), AMREX_SPACEDIM-1);
+            IntVect edge_type{1}; edge_type[idim] = 0;
+            merge(m_edgecent[idim], patch.m_edgecent[idim], edge_type, 1);
+        }
+        Gpu::streamSynchronize();
+
+        m_grids = std::move(grids);
+        m_dmap = std::move(dmap);
+    }
+
+    m_allregular = m_grids.empty() && m_covered_grids.empty();
+}
+
 }
@@ -0,0 +1,173 @@
+#include <AMReX_EBCellLists.H>
+#include <AMReX_BoxList.H>
+
+namespace amrex {
+
+namespace {
+
+    // Number of non-regular cells in boxes of a tile from a summed-area table
+    struct IrregularCounter
+    {
+        IrregularCounter (Array4<EBCellFlag const> const& flag, Box const& tbx)
+            : lo(amrex::lbound(tbx)),
+              nx(tbx.length(0)+1),
+              ny((AMREX_SPACEDIM > 1) ? tbx.length(1)+1 : 2),
+              nz((AMREX_SPACEDIM > 2) ? tbx.length(2)+1 : 2),
+              sum(std::size_t(nx)*ny*nz, 0)
+        {
+            const auto hi = amrex::ubound(tbx);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                const int ii = i-lo.x+1, jj = j-lo.y+1, kk = k-lo.z+1;
+                S(ii,jj,kk) = (flag(i,j,k).isRegular() ? 0 : 1)
+                    + S(ii-1,jj,kk) + S(ii,jj-1,kk) + S(ii,jj,kk-1)
+                    - S(ii-1,jj-1,kk) - S(ii-1,jj,kk-1) - S(ii,jj-1,kk-1)
+                    + S(ii-1,jj-1,kk-1);
+            }}}
+        }
+
+        [[nodiscard]] Long operator() (Box const& b) const noexcept
+        {
+            const auto blo = amrex::lbound(b);
+            const auto bhi = amrex::ubound(b);
+            const int i0 = blo.x-lo.x, j0 = blo.y-lo.y, k0 = blo.z-lo.z;
+            const int i1 = bhi.x-lo.x+1, j1 = bhi.y-lo.y+1, k1 = bhi.z-lo.z+1;
+            return S(i1,j1,k1) - S(i0,j1,k1) - S(i1,j0,k1) - S(i1,j1,k0)
+                + S(i0,j0,k1) + S(i0,j1,k0) + S(i1,j0,k0) - S(i0,j0,k0);
+        }
+
+        [[nodiscard]] Long& S (int i, int j, int k) noexcept {
+            return sum[i+std::size_t(nx)*(j+std::size_t(ny)*k)];
+        }
+        [[nodiscard]] Long S (int i, int j, int k) const noexcept {
+            return sum[i+std::size_t(nx)*(j+std::size_t(ny)*k)];
+        }
+
+        Dim3 lo;
+        int nx, ny, nz;
+        Vector<Long> sum;
+    };
+
+    void split_tile (Box const& b, IrregularCounter const& counter,
+                     Array4<EBCellFlag const> const& flag, int min_width,
+                     BoxList& regular, Vector<IntVect>& cells)
+    {
+        const Long n = counter(b);
+        if (n == 0) {
+            regular.push_back(b);
+            return;
+        }
+
+        int dir = 0;
+        const int len = b.longside(dir);
+        if (n == b.numPts() || len < 2*min_width) {
+            const auto lo = amrex::lbound(b);
+            const auto hi = amrex::ubound(b);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                if (!flag(i,j,k).isCovered()) {
+                    cells.emplace_back(AMREX_D_DECL(i,j,k));
+                }
+            }}}
+            return;
+        }
+
+        Box lo_half = b;
+        Box hi_half = lo_half.chop(dir, b.smallEnd(dir) + len/2);
+        split_tile(lo_half, counter, flag, min_width, regular, cells);
+        split_tile(hi_half, counter, flag, min_width, regular, cells);
+    }
+}
+
+EBCellLists::EBCellLists (FabArray<EBCellFlagFab> const& flags, MFItInfo const& info,
+                          int min_width)
+{
+    BL_PROFILE("EBCellLists::define()");
+
+    AMREX_ALWAYS_ASSERT(min_width > 0);
+
+    MFIter mfi(flags, info);
+    const int ntiles = mfi.length();
+
+    m_tilebox.resize(ntiles);
+    m_regular_boxes.resize(ntiles);
+    m_cell_offset.resize(ntiles+1, 0);
+
+    Vector<IntVect> h_cells;
+
+    for (; mfi.isValid(); ++mfi)
+    {
+        const int t = mfi.tileIndex();
+        Box const& tbx = mfi.tilebox();
+        m_tilebox[t] = tbx;
+
+        const FabType ft = flags[mfi].getType(tbx);
+        if (ft == FabType::regular) {
+            m_regular_boxes[t].push_back(tbx);
+        } else if (ft != FabType::covered) {
+#ifdef AMREX_USE_GPU
+            BaseFab<EBCellFlag> host_flag(tbx, 1, The_Pinned_Arena());
+            host_flag.copy<RunOn::Device>(flags[mfi], tbx, 0, tbx, 0, 1);
+            Gpu::streamSynchronize();
+            auto const& flag = host_flag.const_array();
+#else
+            auto const& flag = flags.const_array(mfi);
+#endif
+            IrregularCounter counter(flag, tbx);
+            BoxList regular;
+            Vector<IntVect> cells;
+            split_tile(tbx, counter, flag, min_width, regular, cells);
+            regular.simplify();
+            m_regular_boxes[t] = regular.data();
+            m_cell_offset[t+1] = static_cast<int>(cells.size());
+            h_cells.insert(h_cells.end(), cells.begin(), cells.end());
+        }
+    }
+
+    // Tiles were visited in order, so the counts become offsets.
+    for (int t = 0; t < ntiles; ++t) {
+        m_cell_offset[t+1] += m_cell_offset[t];
+    }
+
+    // The regular boxes of all tiles in one array, and for each tile the
+    // offsets of the first cell of its boxes plus the total.
+    m_num_regular_cells.resize(ntiles, 0);
+    m_box_offset.resize(ntiles+1, 0);
+    Vector<Box> h_boxes;
+    Vector<int> h_box_cell_offset;
+    for (int t = 0; t < ntiles; ++t) {
+        m_box_offset[t+1] = m_box_offset[t] + static_cast<int>(m_regular_boxes[t].size());
+        int ncells = 0;
+        for (Box const& b : m_regular_boxes[t]) {
+            h_boxes.push_back(b);
+            h_box_cell_offset.push_back(ncells);
+            ncells += static_cast<int>(b.numPts());
+        }
+        h_box_cell_offset.push_back(ncells);
+        m_num_regular_cells[t] = ncells;
+    }
+
+    m_d_boxes.resize(h_boxes.size());
+    Gpu::copyAsync(Gpu::hostToDevice, h_boxes.begin(), h_boxes.end(), m_d_boxes.begin());
+    m_d_box_cell_offset.resize(h_box_cell_offset.size());
+    Gpu::copyAsync(Gpu::hostToDevice, h_box_cell_offset.begin(), h_box_cell_offset.end(),
+                   m_d_box_cell_offset.begin());
+
+    m_cells.resize(h_cells.size());
+    Gpu::copyAsync(Gpu::hostToDevice, h_cells.begin(), h_cells.end(), m_cells.begin());
+    Gpu::streamSynchronize();
+}
+
+Long
+EBCellLists::numRegularBoxes () const noexcept
+{
+    Long r = 0;
+    for (auto const& v : m_regular_boxes) {
+        r += static_cast<Long>(v.size());
+    }
+    return r;
+}
+
+}
@@ -3,6 +3,7 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_iMultiFab.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_EB_utils.H>
 
 #include <AMReX_EB2_Level.H>
 #include <utility>
@@ -89,6 +90,7 @@ EBDataCollection::~EBDataCollection ()
         delete m_edgecent[idim];
     }
     delete m_cutcellmask;
+    delete m_signed_distance;
 }
 
 const FabArray<EBCellFlagFab>&
@@ -167,4 +169,22 @@ EBDataCollection::getCutCellMask () const
     return m_cutcellmask;
 }
 
+const MultiFab&
+EBDataCollection::getSignedDistance (int nband) const
+{
+    AMREX_ALWAYS_ASSERT(m_support == EBSupport::full);
+    if (m_signed_distance == nullptr || m_signed_distance_nband != nband) {
+        if (m_signed_distance == nullptr) {
+            m_signed_distance = new MultiFab(amrex::convert(m_cellflags->boxArray(),
+                                                            IntVect::TheNodeVector()),
+                                             m_cellflags->DistributionMap(), 1, m_ngrow[2],
+                                             MFInfo(), FArrayBoxFactory());
+        }
+        FillSignedDistanceNarrowBand(*m_signed_distance, *m_cellflags, *m_levelset,
+                                     *m_bndrycent, *m_bndrynorm, m_geom, nband);
+        m_signed_distance_nband = nband;
+    }
+    return *m_signed_distance;
+}
+
 }
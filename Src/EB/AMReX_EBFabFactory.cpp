@@ -8,6 +8,8 @@
 #include <AMReX_EB2_Level.H>
 #include <AMReX_EB2.H>
 
+#include <algorithm>
+
 namespace amrex
 {
 
@@ -121,9 +123,7 @@ makeEBFabFactory (const Geometry& a_geom,
                   const DistributionMapping& a_dm,
                   const Vector<int>& a_ngrow, EBSupport a_support)
 {
-    const EB2::IndexSpace& index_space = EB2::IndexSpace::top();
-    const EB2::Level& eb_level = index_space.getLevel(a_geom);
-    return std::make_unique<EBFArrayBoxFactory>(eb_level, a_geom, a_ba, a_dm, a_ngrow, a_support);
+    return makeEBFabFactory(&EB2::IndexSpace::top(), a_geom, a_ba, a_dm, a_ngrow, a_support);
 }
 
 std::unique_ptr<EBFArrayBoxFactory>
@@ -142,6 +142,10 @@ makeEBFabFactory (const EB2::IndexSpace* index_space, const Geometry& a_geom,
                   const DistributionMapping& a_dm,
                   const Vector<int>& a_ngrow, EBSupport a_support)
 {
+    // Levels whose EB is built on demand need it on a_ba first.
+    const int ngrow = *std::max_element(a_ngrow.begin(), a_ngrow.end());
+    const_cast<EB2::IndexSpace*>(index_space)->extendLevel(a_geom, a_ba, ngrow);
+
     const EB2::Level& eb_level = index_space->getLevel(a_geom);
     return std::make_unique<EBFArrayBoxFactory>(eb_level, a_geom,
                                                 a_ba, a_dm, a_ngrow, a_support);
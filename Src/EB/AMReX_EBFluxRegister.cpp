@@ -43,6 +43,10 @@ EBFluxRegister::define (const BoxArray& fba, const BoxArray& cba,
 void
 EBFluxRegister::defineExtra (const BoxArray& fba, const DistributionMapping& fdm)
 {
+    m_reflux_table.clear();
+    m_reflux_table_defined = false;
+    m_grown_crse_data.clear();
+
     BoxArray cfba = fba;
     cfba.coarsen(m_ratio);
     m_cfp_inside_mask.define(cfba, fdm, 1, 0, MFInfo(),DefaultFabFactory<IArrayBox>());
@@ -72,6 +76,118 @@ EBFluxRegister::defineExtra (const BoxArray& fba, const DistributionMapping& fdm
     }
 }
 
+void
+EBFluxRegister::defineRerefluxTable (const MultiFab& crse_vfrac,
+                                     const FabArray<EBCellFlagFab>& flags)
+{
+    BL_PROFILE("EBFluxRegister::defineRerefluxTable()");
+
+    const Box& gdomain = m_crse_geom.growPeriodicDomain(1);
+
+    // Use the same tiles as the kernels the table replaces so that the
+    // cells of regular tiles are still simply added.
+    m_reflux_table_tiled = Gpu::notInLaunchRegion();
+    MFItInfo info;
+    if (m_reflux_table_tiled) { info.EnableTiling(); }
+
+    MFIter mfi(m_crse_data, info);
+    const int ntiles = mfi.length();
+
+    m_reflux_table.clear();
+    m_reflux_table.resize(ntiles);
+
+    Vector<Vector<RerefluxEntry>> h_entries(ntiles);
+
+    for (; mfi.isValid(); ++mfi)
+    {
+        const int t = mfi.tileIndex();
+        if (m_crse_fab_flag[mfi.LocalIndex()] != fine_cell) { continue; } // no crse/fine cells
+
+        const Box& bx = mfi.tilebox();
+        const auto& ebflag = flags[mfi];
+        if (ebflag.getType(bx) == FabType::covered) { continue; }
+
+        const Box& bxg1 = amrex::grow(bx,1) & gdomain;
+        if (ebflag.getType(bxg1) == FabType::regular) {
+            m_reflux_table[t].regular = true;
+            continue;
+        }
+
+#ifdef AMREX_USE_GPU
+        const Box& bxg2 = amrex::grow(bxg1,1) & mfi.fabbox();
+        IArrayBox h_amrflag_fab(bxg1, 1, The_Pinned_Arena());
+        BaseFab<EBCellFlag> h_ebflag_fab(bxg2, 1, The_Pinned_Arena());
+        FArrayBox h_cvol_fab(bxg2, 1, The_Pinned_Arena());
+        h_amrflag_fab.copy<RunOn::Device>(m_crse_flag[mfi], bxg1, 0, bxg1, 0, 1);
+        h_ebflag_fab.copy<RunOn::Device>(ebflag, bxg2, 0, bxg2, 0, 1);
+        h_cvol_fab.copy<RunOn::Device>(crse_vfrac[mfi], bxg2, 0, bxg2, 0, 1);
+        Gpu::streamSynchronize();
+        Array4<int const> const& amrflag = h_amrflag_fab.const_array();
+        Array4<EBCellFlag const> const& ebflagarr = h_ebflag_fab.const_array();
+        Array4<Real const> const& cvol = h_cvol_fab.const_array();
+#else
+        Array4<int const> const& amrflag = m_crse_flag.const_array(mfi);
+        Array4<EBCellFlag const> const& ebflagarr = ebflag.const_array();
+        Array4<Real const> const& cvol = crse_vfrac.const_array(mfi);
+#endif
+
+        // This follows eb_rereflux_from_crse.
+        auto& entries = h_entries[t];
+        constexpr int kr = (AMREX_SPACEDIM == 3) ? 1 : 0;
+        amrex::LoopOnCpu(bxg1, [&] (int i, int j, int k) noexcept
+        {
+            if (amrflag(i,j,k) != amrex_yafluxreg_crse_fine_boundary_cell) { return; }
+
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            auto flag = ebflagarr(i,j,k);
+            if (flag.isRegular())
+            {
+                if (bx.contains(iv)) {
+                    entries.push_back(RerefluxEntry{iv, iv, Real(1.0), Real(1.0)});
+                }
+            }
+            else if (flag.isSingleValued())
+            {
+                const Real vf = cvol(i,j,k);
+                if (bx.contains(iv)) {
+                    entries.push_back(RerefluxEntry{iv, iv, vf, Real(1.0)});
+                }
+
+                Real wtot = Real(0.0);
+                for (int kk = -kr; kk <= kr; ++kk) {
+                for (int jj = -1; jj <= 1; ++jj) {
+                for (int ii = -1; ii <= 1; ++ii) {
+                    if ((ii != 0 || jj != 0 || kk != 0) && flag.isConnected(ii,jj,kk)) {
+                        wtot += cvol(i+ii,j+jj,k+kk);
+                    }
+                }}}
+
+                const Real fac = (Real(1.0)-vf)/wtot;
+                for (int kk = -kr; kk <= kr; ++kk) {
+                for (int jj = -1; jj <= 1; ++jj) {
+                for (int ii = -1; ii <= 1; ++ii) {
+                    if ((ii != 0 || jj != 0 || kk != 0) && flag.isConnected(ii,jj,kk)) {
+                        const IntVect nb(AMREX_D_DECL(i+ii,j+jj,k+kk));
+                        if (bx.contains(nb)) {
+                            entries.push_back(RerefluxEntry{iv, nb, vf, fac});
+                        }
+                    }
+                }}}
+            }
+        });
+    }
+
+    for (int t = 0; t < ntiles; ++t) {
+        auto& d_entries = m_reflux_table[t].entries;
+        d_entries.resize(h_entries[t].size());
+        Gpu::copyAsync(Gpu::hostToDevice, h_entries[t].begin(), h_entries[t].end(),
+                       d_entries.begin());
+    }
+    Gpu::streamSynchronize();
+
+    m_reflux_table_defined = true;
+}
+
 void
 EBFluxRegister::CrseAdd (const MFIter& mfi,
                          const std::array<FArrayBox const*, AMREX_SPACEDIM>& flux,
@@ -327,18 +443,21 @@ EBFluxRegister::Reflux (MultiFab& crse_state, const amrex::MultiFab& crse_vfrac,
     m_crse_data.ParallelCopy(m_cfpatch, srccomp, srccomp, numcomp, m_crse_geom.periodicity(), FabArrayBase::ADD);
 
     {
-        MultiFab grown_crse_data(m_crse_data.boxArray(), m_crse_data.DistributionMap(),
-                                 numcomp, 1, MFInfo(), FArrayBoxFactory());
-        MultiFab::Copy(grown_crse_data, m_crse_data, srccomp, 0, numcomp, 0);
-        grown_crse_data.FillBoundary(m_crse_geom.periodicity());
+        if (m_grown_crse_data.empty()) {
+            m_grown_crse_data.define(m_crse_data.boxArray(), m_crse_data.DistributionMap(),
+                                     m_ncomp, 1, MFInfo(), FArrayBoxFactory());
+        }
+        MultiFab::Copy(m_grown_crse_data, m_crse_data, srccomp, 0, numcomp, 0);
+        m_grown_crse_data.FillBoundary(0, numcomp, m_crse_geom.periodicity());
 
         m_crse_data.setVal(0.0, srccomp, numcomp);
 
-        auto const& factory = dynamic_cast<EBFArrayBoxFactory const&>(crse_state.Factory());
-        auto const& flags = factory.getMultiEBCellFlagFab();
-
-        const Box& gdomain = m_crse_geom.growPeriodicDomain(1);
+        if (!m_reflux_table_defined || m_reflux_table_tiled != Gpu::notInLaunchRegion()) {
+            auto const& factory = dynamic_cast<EBFArrayBoxFactory const&>(crse_state.Factory());
+            defineRerefluxTable(crse_vfrac, factory.getMultiEBCellFlagFab());
+        }
 
+        // Each tile only writes to its own cells.
         MFItInfo info;
         if (Gpu::notInLaunchRegion()) { info.EnableTiling().SetDynamic(true); }
 #ifdef AMREX_USE_OMP
@@ -346,33 +465,33 @@ EBFluxRegister::Reflux (MultiFab& crse_state, const amrex::MultiFab& crse_vfrac,
 #endif
         for (MFIter mfi(m_crse_data, info); mfi.isValid(); ++mfi)
         {
-            if (m_crse_fab_flag[mfi.LocalIndex()] == fine_cell) // fab has crse/fine cells
+            auto const& tbl = m_reflux_table[mfi.tileIndex()];
+            Array4<Real      > const& dfab = m_crse_data.array(mfi,srccomp);
+            Array4<Real const> const& sfab = m_grown_crse_data.const_array(mfi);
+
+            if (tbl.regular)
             {
+                // no re-reflux or re-re-redistribution
                 const Box& bx = mfi.tilebox();
-                const auto& ebflag = flags[mfi];
-                if (ebflag.getType(bx) != FabType::covered) {
-                    const Box& bxg1 = amrex::grow(bx,1) & gdomain;
-                    Array4<Real      > const& dfab = m_crse_data.array(mfi,srccomp);
-                    Array4<Real const> const& sfab = grown_crse_data.const_array(mfi);
-                    if (ebflag.getType(bxg1) == FabType::regular)
-                    {
-                        // no re-reflux or re-re-redistribution
-                        AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, numcomp, i, j, k, n,
-                        {
-                            dfab(i,j,k,n) += sfab(i,j,k,n);
-                        });
-                    }
-                    else
-                    {
-                        Array4<int const> const& amrflag = m_crse_flag.const_array(mfi);
-                        Array4<EBCellFlag const> const& ebflagarr = ebflag.const_array();
-                        Array4<Real const> const& cvol = crse_vfrac.const_array(mfi);
-                        AMREX_HOST_DEVICE_FOR_4D(bxg1, numcomp, i, j, k, n,
-                        {
-                             eb_rereflux_from_crse(i,j,k,n,bx,dfab,sfab,amrflag,ebflagarr,cvol);
-                        });
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, numcomp, i, j, k, n,
+                {
+                    dfab(i,j,k,n) += sfab(i,j,k,n);
+                });
+            }
+
+            const int nentries = static_cast<int>(tbl.entries.size());
+            if (nentries > 0) {
+                RerefluxEntry const* AMREX_RESTRICT entries = tbl.entries.data();
+                amrex::ParallelFor(nentries, [=] AMREX_GPU_DEVICE (int ie) noexcept
+                {
+                    RerefluxEntry const& e = entries[ie];
+                    const Dim3 sc = e.src.dim3();
+                    const Dim3 dc = e.dst.dim3();
+                    for (int n = 0; n < numcomp; ++n) {
+                        HostDevice::Atomic::Add(dfab.ptr(dc.x,dc.y,dc.z,n),
+                                                (sfab(sc.x,sc.y,sc.z,n)*e.wgt0)*e.wgt1);
                     }
-                }
+                });
             }
         }
     }
@@ -0,0 +1,231 @@
+/**
+ * \file AMReX_EB_StateRedistributor.cpp
+ */
+
+#include <AMReX_EB_StateRedistributor.H>
+
+namespace amrex {
+
+EBStateRedistributor::EBStateRedistributor (Geometry const& geom,
+                                            EBFArrayBoxFactory const& factory,
+                                            Real target_volfrac, int max_order)
+    : m_geom(geom),
+      m_factory(&factory),
+      m_target_volfrac(target_volfrac),
+      m_max_order(max_order)
+{
+    BL_PROFILE("EBStateRedistributor::define()");
+
+    auto const& flags = factory.getMultiEBCellFlagFab();
+
+    // MakeITracker looks at the neighbors of the cells within 4 cells of
+    // the valid box.
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(flags.nGrowVect().allGE(IntVect(5)),
+                                     "EBStateRedistributor: EB factory needs at least 5 ghost cells");
+
+    m_data.resize(flags.local_size());
+
+    int num_cut_boxes = 0;
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        // Cells farther than 4 cells away cannot be merged with, or be in
+        // the neighborhood of, a valid cell.
+        const FabType t = flags[mfi].getType(amrex::grow(mfi.validbox(),4));
+        if (t == FabType::regular || t == FabType::covered) { continue; }
+
+        auto cbd = std::make_unique<CutBoxData>();
+        define_box(mfi, *cbd);
+        m_data[mfi.LocalIndex()] = std::move(cbd);
+        ++num_cut_boxes;
+    }
+    m_num_cut_boxes = num_cut_boxes;
+}
+
+void
+EBStateRedistributor::define_box (MFIter const& mfi, CutBoxData& cbd) const
+{
+    Box const& bx = mfi.validbox();
+    Box const& bxg3 = amrex::grow(bx,3);
+    Box const& bxg4 = amrex::grow(bx,4);
+
+    // See ApplyMLRedistribution for the meaning of these.
+    cbd.itracker.resize(bxg4, (AMREX_SPACEDIM == 2) ? 4 : 8, The_Arena());
+    cbd.nrs.resize(bxg4, 1, The_Arena());
+    cbd.alpha.resize(bxg3, 2, The_Arena());
+    cbd.nbhd_vol.resize(bxg3, 1, The_Arena());
+    cbd.cent_hat.resize(bxg3, AMREX_SPACEDIM, The_Arena());
+
+    auto const& flag = m_factory->getMultiEBCellFlagFab().const_array(mfi);
+    auto const& vfrac = m_factory->getVolFrac().const_array(mfi);
+    auto const& ccc = m_factory->getCentroid().const_array(mfi);
+    auto const& area = m_factory->getAreaFrac();
+    AMREX_D_TERM(auto const& apx = area[0]->const_array(mfi);,
+                 auto const& apy = area[1]->const_array(mfi);,
+                 auto const& apz = area[2]->const_array(mfi););
+
+    MakeITracker(bx, AMREX_D_DECL(apx, apy, apz), vfrac, cbd.itracker.array(),
+                 m_geom, m_target_volfrac);
+
+    MakeStateRedistUtils(bx, flag, vfrac, ccc, cbd.itracker.const_array(),
+                         cbd.nrs.array(), cbd.alpha.array(), cbd.nbhd_vol.array(),
+                         cbd.cent_hat.array(), m_geom, m_target_volfrac);
+}
+
+void
+EBStateRedistributor::apply (MultiFab& dUdt_out, MultiFab& dUdt_in, MultiFab const& U_in,
+                             int scomp, int ncomp, Real dt, BCRec const* d_bcrec_ptr,
+                             MultiFab const* update_scale) const
+{
+    BL_PROFILE("EBStateRedistributor::apply()");
+
+    AMREX_ASSERT(dUdt_out.local_size() == static_cast<int>(m_data.size()));
+    AMREX_ASSERT(dUdt_in.nGrowVect().allGE(IntVect(3)) && U_in.nGrowVect().allGE(IntVect(3)));
+
+    auto const& flags = m_factory->getMultiEBCellFlagFab();
+    auto const& fcent = m_factory->getFaceCent();
+
+    Box domain_per_grown = m_geom.Domain();
+    AMREX_D_TERM(if (m_geom.isPeriodic(0)) { domain_per_grown.grow(0,1); },
+                 if (m_geom.isPeriodic(1)) { domain_per_grown.grow(1,1); },
+                 if (m_geom.isPeriodic(2)) { domain_per_grown.grow(2,1); })
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dUdt_out); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        auto const& out = dUdt_out.array(mfi, scomp);
+        auto const& din = dUdt_in.array(mfi, scomp);
+
+        CutBoxData const* cbd = m_data[mfi.LocalIndex()].get();
+        if (cbd == nullptr)
+        {
+            // No cell of this box is merged with anything.
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                out(i,j,k,n) = din(i,j,k,n);
+            });
+            continue;
+        }
+
+        auto const& uin = U_in.const_array(mfi, scomp);
+        Array4<Real const> scale = (update_scale) ? update_scale->const_array(mfi)
+                                                  : Array4<Real const>{};
+
+        auto const& flag = flags.const_array(mfi);
+        auto const& vfrac = m_factory->getVolFrac().const_array(mfi);
+        auto const& ccc = m_factory->getCentroid().const_array(mfi);
+        AMREX_D_TERM(auto const& fcx = fcent[0]->const_array(mfi);,
+                     auto const& fcy = fcent[1]->const_array(mfi);,
+                     auto const& fcz = fcent[2]->const_array(mfi););
+
+        auto const& itr = cbd->itracker.const_array();
+        auto const& nrs = cbd->nrs.const_array();
+
+        Box const& bxg1 = amrex::grow(bx,1);
+        Box const& bxg3 = amrex::grow(bx,3);
+
+        // At external Dirichlet domain boundaries dUdt_in just outside the
+        // domain is used in the slope computation and must be zero.
+        if (!domain_per_grown.contains(bxg1)) {
+            amrex::ParallelFor(bxg1, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (!domain_per_grown.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                    din(i,j,k,n) = 0.;
+                }
+            });
+        }
+
+        FArrayBox scratch_fab(bxg3, ncomp, The_Async_Arena());
+        auto const& scratch = scratch_fab.array();
+
+        amrex::ParallelFor(bxg3, ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            const Real s = (scale) ? scale(i,j,k) : Real(1.0);
+            scratch(i,j,k,n) = uin(i,j,k,n) + dt * din(i,j,k,n) / s;
+            if (bx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                out(i,j,k,n) = 0.;
+            }
+        });
+
+        StateRedistribute(bx, ncomp, out, scratch, flag, vfrac,
+                          AMREX_D_DECL(fcx, fcy, fcz), ccc, d_bcrec_ptr,
+                          itr, nrs, cbd->alpha.const_array(), cbd->nbhd_vol.const_array(),
+                          cbd->cent_hat.const_array(), m_geom, m_max_order);
+
+        amrex::ParallelFor(bx, ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            // Only update the cells that are merged or in a neighborhood so
+            // that the other cells are bit-for-bit unchanged.
+            if (itr(i,j,k,0) > 0 || nrs(i,j,k) > 1.)
+            {
+                const Real s = (scale) ? scale(i,j,k) : Real(1.0);
+                out(i,j,k,n) = s * (out(i,j,k,n) - uin(i,j,k,n)) / dt;
+            }
+            else
+            {
+                out(i,j,k,n) = din(i,j,k,n);
+            }
+        });
+    }
+}
+
+void
+EBStateRedistributor::applyInitial (MultiFab& U_out, MultiFab& U_in,
+                                    int scomp, int ncomp, BCRec const* d_bcrec_ptr) const
+{
+    BL_PROFILE("EBStateRedistributor::applyInitial()");
+
+    AMREX_ASSERT(U_out.local_size() == static_cast<int>(m_data.size()));
+    AMREX_ASSERT(U_in.nGrowVect().allGE(IntVect(3)));
+
+    auto const& flags = m_factory->getMultiEBCellFlagFab();
+    auto const& fcent = m_factory->getFaceCent();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(U_out); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        auto const& out = U_out.array(mfi, scomp);
+        auto const& uin = U_in.array(mfi, scomp);
+        auto const& flag = flags.const_array(mfi);
+
+        CutBoxData const* cbd = m_data[mfi.LocalIndex()].get();
+        if (cbd == nullptr)
+        {
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                out(i,j,k,n) = flag(i,j,k).isCovered() ? Real(1.e30) : uin(i,j,k,n);
+            });
+            continue;
+        }
+
+        auto const& vfrac = m_factory->getVolFrac().const_array(mfi);
+        auto const& ccc = m_factory->getCentroid().const_array(mfi);
+        AMREX_D_TERM(auto const& fcx = fcent[0]->const_array(mfi);,
+                     auto const& fcy = fcent[1]->const_array(mfi);,
+                     auto const& fcz = fcent[2]->const_array(mfi););
+
+        amrex::ParallelFor(bx, ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            out(i,j,k,n) = 0.;
+        });
+
+        StateRedistribute(bx, ncomp, out, uin, flag, vfrac,
+                          AMREX_D_DECL(fcx, fcy, fcz), ccc, d_bcrec_ptr,
+                          cbd->itracker.const_array(), cbd->nrs.const_array(),
+                          cbd->alpha.const_array(), cbd->nbhd_vol.const_array(),
+                          cbd->cent_hat.const_array(), m_geom, m_max_order);
+    }
+}
+
+}
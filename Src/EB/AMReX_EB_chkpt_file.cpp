@@ -4,10 +4,18 @@
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_VisMF.H>    // amrex::VisMF::Write(MultiFab)
 #include <AMReX_VectorIO.H> // amrex::[read,write]IntData(array_of_ints)
+#include <AMReX_NFiles.H>
+#include <AMReX_Loop.H>
+
+#include <climits>
+#include <cstring>
+#include <map>
 #include <utility>
 
 namespace {
 
+using namespace amrex;
+
 const std::string level_prefix = "Level_";
 
 void gotoNextLine (std::istream& is)
@@ -16,6 +24,211 @@ void gotoNextLine (std::istream& is)
     is.ignore(bl_ignore_max, '\n');
 }
 
+// Point classes of the compact format
+constexpr unsigned char regular_point = 0;
+constexpr unsigned char covered_point = 1;
+constexpr unsigned char cut_point     = 2;
+
+template <typename T>
+void append (Vector<char>& buf, T const& x)
+{
+    const auto n = buf.size();
+    buf.resize(n + sizeof(T));
+    std::memcpy(buf.data()+n, &x, sizeof(T));
+}
+
+template <typename T>
+T extract (char const*& p)
+{
+    T x;
+    std::memcpy(&x, p, sizeof(T));
+    p += sizeof(T);
+    return x;
+}
+
+// Host copy of fab on GPU builds, fab itself otherwise
+FArrayBox const& host_fab (FArrayBox const& fab, FArrayBox& tmp)
+{
+#ifdef AMREX_USE_GPU
+    tmp.resize(fab.box(), fab.nComp(), The_Pinned_Arena());
+    Gpu::dtoh_memcpy_async(tmp.dataPtr(), fab.dataPtr(), fab.size()*sizeof(Real));
+    Gpu::streamSynchronize();
+    return tmp;
+#else
+    amrex::ignore_unused(tmp);
+    return fab;
+#endif
+}
+
+// A point is regular (covered) if all the cells it touches are regular
+// (covered) and have a class.  The classes are built one nodal
+// direction at a time.
+BaseFab<unsigned char> point_classes (BaseFab<unsigned char> const& cell_cls, IndexType ixt)
+{
+    BaseFab<unsigned char> cls(cell_cls.box(), 1, The_Cpu_Arena());
+    cls.copy<RunOn::Host>(cell_cls);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (ixt.cellCentered(idim)) { continue; }
+        BaseFab<unsigned char> tmp(amrex::surroundingNodes(cls.box(),idim), 1, The_Cpu_Arena());
+        auto const& ca = cls.const_array();
+        auto const& ta = tmp.array();
+        Box const& cbx = cls.box();
+        const IntVect e = IntVect::TheDimensionVector(idim);
+        amrex::LoopOnCpu(tmp.box(), [&] (int i, int j, int k) noexcept
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            const IntVect ivm = iv - e;
+            if (iv[idim] == cbx.smallEnd(idim) || ivm[idim] == cbx.bigEnd(idim) ||
+                ca(ivm) != ca(iv)) {
+                ta(i,j,k) = cut_point;
+            } else {
+                ta(i,j,k) = ca(iv);
+            }
+        });
+        std::swap(cls, tmp);
+    }
+    return cls;
+}
+
+bool matches (Real v, Real ref, bool sign_only)
+{
+    if (sign_only) {
+        return (ref < 0.0_rt) ? (v < 0.0_rt) : (v > 0.0_rt);
+    } else {
+        return v == ref;
+    }
+}
+
+// For each component: the reference values of the regular and covered
+// classes, the points of these classes not matching them, and the
+// values of the cut points.
+void encode (FArrayBox const& fab, BaseFab<unsigned char> const& cls, bool sign_only,
+             Vector<char>& buf)
+{
+    const Long npts = fab.box().numPts();
+    AMREX_ALWAYS_ASSERT(npts < Long(INT_MAX));
+    unsigned char const* c = cls.dataPtr();
+    for (int n = 0; n < fab.nComp(); ++n) {
+        Real const* v = fab.dataPtr(n);
+        Real ref[2] = {-1.0_rt, 1.0_rt};
+        if (!sign_only) {
+            bool found[2] = {false, false};
+            for (Long m = 0; m < npts; ++m) {
+                if (c[m] != cut_point && !found[c[m]]) {
+                    ref[c[m]] = v[m];
+                    found[c[m]] = true;
+                }
+            }
+        }
+        Vector<char> exceptions;
+        Vector<Real> literals;
+        int nexceptions = 0;
+        for (Long m = 0; m < npts; ++m) {
+            if (c[m] == cut_point) {
+                literals.push_back(v[m]);
+            } else if (!matches(v[m], ref[c[m]], sign_only)) {
+                append(exceptions, static_cast<int>(m));
+                append(exceptions, v[m]);
+                ++nexceptions;
+            }
+        }
+        append(buf, ref[0]);
+        append(buf, ref[1]);
+        append(buf, nexceptions);
+        buf.insert(buf.end(), exceptions.begin(), exceptions.end());
+        const auto n0 = buf.size();
+        buf.resize(n0 + literals.size()*sizeof(Real));
+        if (!literals.empty()) {
+            std::memcpy(buf.data()+n0, literals.data(), literals.size()*sizeof(Real));
+        }
+    }
+}
+
+void decode (char const*& p, BaseFab<unsigned char> const& cls, FArrayBox& fab)
+{
+    const Long npts = fab.box().numPts();
+    unsigned char const* c = cls.dataPtr();
+    for (int n = 0; n < fab.nComp(); ++n) {
+        Real* v = fab.dataPtr(n);
+        Real ref[2];
+        ref[0] = extract<Real>(p);
+        ref[1] = extract<Real>(p);
+        const int nexceptions = extract<int>(p);
+        char const* pexc = p;
+        p += nexceptions * (sizeof(int)+sizeof(Real));
+        for (Long m = 0; m < npts; ++m) {
+            v[m] = (c[m] == cut_point) ? extract<Real>(p) : ref[c[m]];
+        }
+        for (int e = 0; e < nexceptions; ++e) {
+            const int m = extract<int>(pexc);
+            v[m] = extract<Real>(pexc);
+        }
+    }
+}
+
+// The cell classes, four per byte, followed by the data of each MultiFab
+void encode_box (Vector<MultiFab const*> const& mfs, MFIter const& mfi, Vector<char>& buf)
+{
+    FArrayBox tmp;
+    FArrayBox const& vfrac = host_fab((*mfs[0])[mfi], tmp);
+    BaseFab<unsigned char> cell_cls(vfrac.box(), 1, The_Cpu_Arena());
+    const Long ncells = vfrac.box().numPts();
+    {
+        Real const* vf = vfrac.dataPtr();
+        unsigned char* c = cell_cls.dataPtr();
+        Vector<unsigned char> packed((ncells+3)/4, 0);
+        for (Long m = 0; m < ncells; ++m) {
+            c[m] = (vf[m] == 1.0_rt) ? regular_point
+                : ((vf[m] == 0.0_rt) ? covered_point : cut_point);
+            packed[m/4] |= static_cast<unsigned char>(c[m] << (2*(m%4)));
+        }
+        buf.insert(buf.end(), packed.begin(), packed.end());
+    }
+
+    std::map<IndexType,BaseFab<unsigned char>> cls;
+    for (int i = 0, N = static_cast<int>(mfs.size()); i < N; ++i) {
+        FArrayBox const& fab = host_fab((*mfs[i])[mfi], tmp);
+        const IndexType ixt = fab.box().ixType();
+        if (cls.count(ixt) == 0) {
+            cls.emplace(ixt, point_classes(cell_cls, ixt));
+        }
+        AMREX_ASSERT(cls[ixt].box() == fab.box());
+        encode(fab, cls[ixt], i == N-1, buf);
+    }
+}
+
+void decode_box (char const* p, Vector<MultiFab*> const& mfs, MFIter const& mfi)
+{
+    BaseFab<unsigned char> cell_cls((*mfs[0])[mfi].box(), 1, The_Cpu_Arena());
+    const Long ncells = cell_cls.box().numPts();
+    {
+        unsigned char* c = cell_cls.dataPtr();
+        for (Long m = 0; m < ncells; ++m) {
+            c[m] = (static_cast<unsigned char>(p[m/4]) >> (2*(m%4))) & 3;
+        }
+        p += (ncells+3)/4;
+    }
+
+    std::map<IndexType,BaseFab<unsigned char>> point_cls;
+    for (auto* mf : mfs) {
+        FArrayBox& fab = (*mf)[mfi];
+        const IndexType ixt = fab.box().ixType();
+        if (point_cls.count(ixt) == 0) {
+            point_cls.emplace(ixt, point_classes(cell_cls, ixt));
+        }
+        auto const& cls = point_cls[ixt];
+        AMREX_ASSERT(cls.box() == fab.box());
+#ifdef AMREX_USE_GPU
+        FArrayBox tmp(fab.box(), fab.nComp(), The_Pinned_Arena());
+        decode(p, cls, tmp);
+        Gpu::htod_memcpy_async(fab.dataPtr(), tmp.dataPtr(), fab.size()*sizeof(Real));
+        Gpu::streamSynchronize();
+#else
+        decode(p, cls, fab);
+#endif
+    }
+}
+
 }
 
 namespace amrex::EB2 {
@@ -26,7 +239,7 @@ void
 ChkptFile::writeHeader (const BoxArray& cut_ba, const BoxArray& covered_ba,
                         const Geometry& geom,
                         const IntVect& ngrow, bool extend_domain_face,
-                        int max_grid_size) const
+                        int max_grid_size, int version) const
 {
     if (ParallelDescriptor::IOProcessor())
     {
@@ -46,7 +259,7 @@ ChkptFile::writeHeader (const BoxArray& cut_ba, const BoxArray& covered_ba,
 
         HeaderFile.precision(17);
 
-        HeaderFile << "Checkpoint version: 1\n";
+        HeaderFile << "Checkpoint version: " << version << "\n";
 
         const int nlevels = 1;
         HeaderFile << nlevels << "\n";
@@ -95,6 +308,105 @@ ChkptFile::writeToFile (const MultiFab& mf, const std::string& mf_name) const
                 level_prefix, mf_name));
 }
 
+// Each process encodes its boxes and then they are written with
+// NFilesIter.  The index file has the file number, offset and size of
+// the record of each box.
+void
+ChkptFile::writeCompact (const Vector<MultiFab const*>& mfs) const
+{
+    BL_PROFILE("EB2::ChkptFile::writeCompact()");
+
+    const MultiFab& volfrac = *mfs[0];
+
+    Vector<Vector<char>> records(volfrac.local_size());
+    for (MFIter mfi(volfrac); mfi.isValid(); ++mfi) {
+        encode_box(mfs, mfi, records[mfi.LocalIndex()]);
+    }
+
+    const auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_compact_data_name);
+    const int nboxes = volfrac.size();
+    Vector<Long> index(3*nboxes, 0);
+
+    NFilesIter nfi(VisMF::GetNOutFiles(), prefix + "_D_", VisMF::GetGroupSets(), VisMF::GetSetBuf());
+    for ( ; nfi.ReadyToWrite(); ++nfi) {
+        for (MFIter mfi(volfrac); mfi.isValid(); ++mfi) {
+            auto const& rec = records[mfi.LocalIndex()];
+            const int i = mfi.index();
+            index[3*i  ] = nfi.FileNumber();
+            index[3*i+1] = static_cast<Long>(nfi.SeekPos());
+            index[3*i+2] = static_cast<Long>(rec.size());
+            nfi.Stream().write(rec.data(), static_cast<std::streamsize>(rec.size()));
+        }
+        nfi.Stream().flush();
+    }
+
+    ParallelDescriptor::ReduceLongSum(index.data(), static_cast<int>(index.size()),
+                                      ParallelDescriptor::IOProcessorNumber());
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::string IndexFileName(prefix + "_H");
+        std::ofstream IndexFile(IndexFileName.c_str(), std::ofstream::out | std::ofstream::trunc);
+        if ( ! IndexFile.good() ) {
+            FileOpenFailed(IndexFileName);
+        }
+
+        IndexFile << sizeof(Real) << "\n";
+        IndexFile << nboxes << "\n";
+        for (int i = 0; i < nboxes; ++i) {
+            IndexFile << index[3*i] << ' ' << index[3*i+1] << ' ' << index[3*i+2] << '\n';
+        }
+    }
+}
+
+// Each process reads the records of its own boxes.
+void
+ChkptFile::readCompact (const Vector<MultiFab*>& mfs) const
+{
+    BL_PROFILE("EB2::ChkptFile::readCompact()");
+
+    const auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_compact_data_name);
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(prefix + "_H", fileCharPtr);
+    std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    int real_size, nboxes;
+    is >> real_size >> nboxes;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(real_size == int(sizeof(Real)),
+                                     "EB2::ChkptFile cannot read compact data of a different precision");
+    AMREX_ALWAYS_ASSERT(nboxes == mfs[0]->size());
+
+    Vector<Long> index(3*nboxes);
+    for (auto& x : index) {
+        is >> x;
+    }
+
+    std::ifstream ifs;
+    int cur_file = -1;
+    Vector<char> rec;
+    for (MFIter mfi(*mfs[0]); mfi.isValid(); ++mfi) {
+        const int i = mfi.index();
+        const auto file_number = static_cast<int>(index[3*i]);
+        if (file_number != cur_file) {
+            ifs.close();
+            const auto file_name = NFilesIter::FileName(file_number, prefix + "_D_");
+            ifs.open(file_name.c_str(), std::ios::in | std::ios::binary);
+            if ( ! ifs.good() ) {
+                FileOpenFailed(file_name);
+            }
+            cur_file = file_number;
+        }
+        rec.resize(index[3*i+2]);
+        ifs.seekg(static_cast<std::streamoff>(index[3*i+1]), std::ios::beg);
+        ifs.read(rec.data(), static_cast<std::streamsize>(rec.size()));
+        if ( ! ifs.good() ) {
+            amrex::Error("EB2::ChkptFile: failed to read compact data of box " + std::to_string(i));
+        }
+        decode_box(rec.data(), mfs, mfi);
+    }
+}
+
 
 ChkptFile::ChkptFile (std::string fname)
     : m_restart_file(std::move(fname))
@@ -133,6 +445,9 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
     std::string line, word;
 
     std::getline(is, line);
+    const int version = std::stoi(line.substr(line.find(':')+1));
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(version == 1 || version == 2,
+                                     "EB2::ChkptFile: unknown checkpoint version");
 
     int nlevs;
     is >> nlevs;
@@ -214,7 +529,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
         volfrac.define(cut_grids, dmap, 1, ng_gfab);
 
         auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_volfrac_name);
-        VisMF::Read(volfrac, prefix);
+        if (version == 1) { VisMF::Read(volfrac, prefix); }
     }
 
     // centroid
@@ -224,7 +539,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
         centroid.define(cut_grids, dmap, AMREX_SPACEDIM, ng_gfab);
 
         auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_centroid_name);
-        VisMF::Read(centroid, prefix);
+        if (version == 1) { VisMF::Read(centroid, prefix); }
     }
 
     // bndryarea
@@ -234,7 +549,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
         bndryarea.define(cut_grids, dmap, 1, ng_gfab);
 
         auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_bndryarea_name);
-        VisMF::Read(bndryarea, prefix);
+        if (version == 1) { VisMF::Read(bndryarea, prefix); }
     }
 
     // bndrycent
@@ -244,7 +559,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
         bndrycent.define(cut_grids, dmap, AMREX_SPACEDIM, ng_gfab);
 
         auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_bndrycent_name);
-        VisMF::Read(bndrycent, prefix);
+        if (version == 1) { VisMF::Read(bndrycent, prefix); }
     }
 
     // bndrynorm
@@ -254,7 +569,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
         bndrynorm.define(cut_grids, dmap, AMREX_SPACEDIM, ng_gfab);
 
         auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_bndrynorm_name);
-        VisMF::Read(bndrynorm, prefix);
+        if (version == 1) { VisMF::Read(bndrynorm, prefix); }
     }
 
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
@@ -265,7 +580,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
             areafrac[idim].define(convert(cut_grids, IntVect::TheDimensionVector(idim)), dmap, 1, ng_gfab);
 
             auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_areafrac_name[idim]);
-            VisMF::Read(areafrac[idim], prefix);
+            if (version == 1) { VisMF::Read(areafrac[idim], prefix); }
         }
 
         // facecent
@@ -275,7 +590,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
             facecent[idim].define(convert(cut_grids, IntVect::TheDimensionVector(idim)), dmap, AMREX_SPACEDIM-1, ng_gfab);
 
             auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_facecent_name[idim]);
-            VisMF::Read(facecent[idim], prefix);
+            if (version == 1) { VisMF::Read(facecent[idim], prefix); }
         }
 
         // edgecent
@@ -286,7 +601,7 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
             edgecent[idim].define(convert(cut_grids, edge_type), dmap, 1, ng_gfab);
 
             auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_edgecent_name[idim]);
-            VisMF::Read(edgecent[idim], prefix);
+            if (version == 1) { VisMF::Read(edgecent[idim], prefix); }
         }
     }
 
@@ -297,7 +612,21 @@ ChkptFile::read_from_chkpt_file (BoxArray& cut_grids, BoxArray& covered_grids,
         levelset.define(convert(cut_grids,IntVect::TheNodeVector()), dmap, 1, ng_gfab);
 
         auto prefix = MultiFabFileFullPrefix(0, m_restart_file, level_prefix, m_levelset_name);
-        VisMF::Read(levelset, prefix);
+        if (version == 1) { VisMF::Read(levelset, prefix); }
+    }
+
+    if (version == 2)
+    {
+        if (amrex::Verbose()) { amrex::Print() << "  Loading compact EB data" << std::endl; }
+
+        Vector<MultiFab*> mfs{&volfrac, &centroid, &bndryarea, &bndrycent, &bndrynorm};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            mfs.push_back(&areafrac[idim]);
+            mfs.push_back(&facecent[idim]);
+            mfs.push_back(&edgecent[idim]);
+        }
+        mfs.push_back(&levelset);
+        readCompact(mfs);
     }
 }
 
@@ -312,9 +641,27 @@ ChkptFile::write_to_chkpt_file (const BoxArray& cut_grids,
                                 const Array<MultiFab,AMREX_SPACEDIM>& edgecent,
                                 const MultiFab& levelset, const Geometry& geom,
                                 const IntVect& ngrow, bool extend_domain_face,
-                                int max_grid_size) const
+                                int max_grid_size, bool compact) const
 {
 
+    Vector<MultiFab const*> mfs;
+    if (compact) {
+        mfs = {&volfrac, &centroid, &bndryarea, &bndrycent, &bndrynorm};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            mfs.push_back(&areafrac[idim]);
+            mfs.push_back(&facecent[idim]);
+            mfs.push_back(&edgecent[idim]);
+        }
+        mfs.push_back(&levelset);
+        // The reader decodes every box with the ghost cells of volfrac.
+        // This is not the case for levels built by coarsening, whose
+        // level set has no ghost nodes.
+        for (auto const* mf : mfs) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(mf->nGrowVect() == volfrac.nGrowVect(),
+                                             "EB2::ChkptFile: the compact format needs the same ghost cells for all the EB data; use compact=false for this level");
+        }
+    }
+
     if (ParallelDescriptor::IOProcessor()) {
         std::cout << "\n\t Writing checkpoint " << m_restart_file << std::endl;
     }
@@ -322,7 +669,13 @@ ChkptFile::write_to_chkpt_file (const BoxArray& cut_grids,
     const int nlevels = 1;
     PreBuildDirectorHierarchy(m_restart_file, level_prefix, nlevels, true);
 
-    writeHeader(cut_grids, covered_grids, geom, ngrow, extend_domain_face, max_grid_size);
+    writeHeader(cut_grids, covered_grids, geom, ngrow, extend_domain_face, max_grid_size,
+                compact ? 2 : 1);
+
+    if (compact) {
+        writeCompact(mfs);
+        return;
+    }
 
     writeToFile(volfrac, m_volfrac_name);
     writeToFile(centroid, m_centroid_name);
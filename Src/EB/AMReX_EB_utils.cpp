@@ -408,4 +408,207 @@ void FillSignedDistance (MultiFab& mf, EB2::Level const& ls_lev,
     mf.FillBoundary(0,1,ls_lev.Geom().periodicity());
 }
 
+namespace {
+// Godunov update of the eikonal equation |grad d| = 1 at a node from the
+// smallest neighbor value a[d] in each direction.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real eikonal_update (GpuArray<Real,AMREX_SPACEDIM> a, GpuArray<Real,AMREX_SPACEDIM> h)
+{
+    // sort by neighbor value
+    for (int m = 1; m < AMREX_SPACEDIM; ++m) {
+        for (int l = m; l > 0 && a[l] < a[l-1]; --l) {
+            amrex::Swap(a[l], a[l-1]);
+            amrex::Swap(h[l], h[l-1]);
+        }
+    }
+
+    Real u = a[0] + h[0];
+    Real A = 0._rt, B = 0._rt, C = -1._rt;
+    for (int m = 0; m < AMREX_SPACEDIM; ++m) {
+        if (m > 0 && u <= a[m]) { break; }
+        Real hinv2 = 1._rt/(h[m]*h[m]);
+        A += hinv2;
+        B += a[m]*hinv2;
+        C += a[m]*a[m]*hinv2;
+        Real disc = B*B - A*C;
+        if (disc < 0._rt) { break; }
+        u = (B + std::sqrt(disc)) / A;
+    }
+    return u;
+}
+}
+
+void FillSignedDistanceNarrowBand (MultiFab& mf, EBFArrayBoxFactory const& eb_fac,
+                                   int nband, bool fluid_has_positive_sign)
+{
+    FillSignedDistanceNarrowBand(mf, eb_fac.getMultiEBCellFlagFab(), eb_fac.getLevelSet(),
+                                 eb_fac.getBndryCent(), eb_fac.getBndryNormal(),
+                                 eb_fac.Geom(), nband, fluid_has_positive_sign);
+}
+
+void FillSignedDistanceNarrowBand (MultiFab& mf, FabArray<EBCellFlagFab> const& flags,
+                                   MultiFab const& levelset, MultiCutFab const& bndrycent,
+                                   MultiCutFab const& bndrynorm, Geometry const& geom,
+                                   int nband, bool fluid_has_positive_sign)
+{
+    BL_PROFILE("FillSignedDistanceNarrowBand()");
+
+    AMREX_ALWAYS_ASSERT(mf.is_nodal() && nband > 0);
+    AMREX_ALWAYS_ASSERT(mf.boxArray().CellEqual(flags.boxArray()) &&
+                        mf.DistributionMap() == flags.DistributionMap());
+
+    const auto dx = geom.CellSizeArray();
+    const Real band = nband * amrex::min(AMREX_D_DECL(dx[0],dx[1],dx[2]));
+    const Real fluid_sign = fluid_has_positive_sign ? 1._rt : -1._rt;
+
+    const IntVect ng = amrex::max(mf.nGrowVect(), IntVect(1));
+    MultiFab dist(mf.boxArray(), mf.DistributionMap(), 1, ng);
+    MultiFab dist_new(mf.boxArray(), mf.DistributionMap(), 1, ng);
+
+    // Nodes of cut cells get the distance to the plane of the nearest
+    // facet, and nodes between regular and covered cells get zero.
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dist); mfi.isValid(); ++mfi)
+    {
+        Box const& nbx = mfi.fabbox();
+        Box const& flag_box = flags[mfi].box();
+        auto const& flag = flags.const_array(mfi);
+        auto const& d = dist.array(mfi);
+
+        const bool has_cut = bndrycent.ok(mfi);
+        Array4<Real const> bc = has_cut ? bndrycent.const_array(mfi) : Array4<Real const>{};
+        Array4<Real const> bn = has_cut ? bndrynorm.const_array(mfi) : Array4<Real const>{};
+
+        amrex::ParallelFor(nbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real dmin = band;
+            bool covered = false;
+            bool uncovered = false;
+#if (AMREX_SPACEDIM == 3)
+            for (int kk = k-1; kk <= k; ++kk) {
+#else
+            for (int kk = k; kk <= k; ++kk) {
+#endif
+            for (int jj = j-1; jj <= j; ++jj) {
+            for (int ii = i-1; ii <= i; ++ii) {
+                if (!flag_box.contains(IntVect(AMREX_D_DECL(ii,jj,kk)))) { continue; }
+                auto const f = flag(ii,jj,kk);
+                if (f.isCovered()) {
+                    covered = true;
+                } else {
+                    uncovered = true;
+                    if (has_cut && f.isSingleValued()) {
+                        // The normal is in index space, so scale it to get
+                        // the physical distance to the facet's plane.
+                        IntVect const node(AMREX_D_DECL(i,j,k));
+                        IntVect const cell(AMREX_D_DECL(ii,jj,kk));
+                        Real num = 0._rt, den = 0._rt;
+                        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                            Real n = bn(ii,jj,kk,dir);
+                            num += n * (Real(node[dir]-cell[dir]) - 0.5_rt - bc(ii,jj,kk,dir));
+                            den += (n/dx[dir]) * (n/dx[dir]);
+                        }
+                        if (den > 0._rt) {
+                            dmin = amrex::min(dmin, std::abs(num)/std::sqrt(den));
+                        }
+                    }
+                }
+            }}}
+            if (covered && uncovered && dmin == band) { dmin = 0._rt; }
+            d(i,j,k) = dmin;
+        });
+    }
+
+    MultiFab::Copy(dist_new, dist, 0, 0, 1, ng);
+
+    // Jacobi version of fast sweeping.  Only the outermost ghost nodes are
+    // not updated.  The ghost nodes inside the domain are then replaced by
+    // the values of their owners.  Each iteration moves the front by one
+    // node, so the loop ends after about nband*AMREX_SPACEDIM iterations.
+    const int max_iter = 100*nband;
+    for (int iter = 0; iter < max_iter; ++iter)
+    {
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<int> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        for (MFIter mfi(dist); mfi.isValid(); ++mfi)
+        {
+            Box const& bx = amrex::grow(mfi.fabbox(), -1);
+            auto const& dold = dist.const_array(mfi);
+            auto const& dnew = dist_new.array(mfi);
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                Real u = dold(i,j,k);
+                GpuArray<Real,AMREX_SPACEDIM> a{AMREX_D_DECL(
+                        amrex::min(dold(i-1,j,k),dold(i+1,j,k)),
+                        amrex::min(dold(i,j-1,k),dold(i,j+1,k)),
+                        amrex::min(dold(i,j,k-1),dold(i,j,k+1)))};
+                GpuArray<Real,AMREX_SPACEDIM> h{AMREX_D_DECL(dx[0],dx[1],dx[2])};
+                Real unew = eikonal_update(a, h);
+                if (unew < u) {
+                    dnew(i,j,k) = unew;
+                    return {1};
+                } else {
+                    dnew(i,j,k) = u;
+                    return {0};
+                }
+            });
+        }
+
+        int nchanged = amrex::get<0>(reduce_data.value(reduce_op));
+        ParallelAllReduce::Sum(nchanged, ParallelContext::CommunicatorSub());
+
+        std::swap(dist, dist_new);
+        dist.FillBoundary(geom.periodicity());
+
+        if (nchanged == 0) { break; }
+    }
+
+    // On valid nodes, the sign comes from the implicit function, which is
+    // positive in the body.  Its ghost nodes are not filled, so the ghost
+    // nodes get theirs from the owners or, outside the domain, from the
+    // cells around them.
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.fabbox();
+        Box const& vbx = mfi.validbox();
+        Box const& flag_box = flags[mfi].box();
+        auto const& flag = flags.const_array(mfi);
+        auto const& ls = levelset.const_array(mfi);
+        auto const& d = dist.const_array(mfi);
+        auto const& fab = mf.array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            bool body;
+            if (vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                body = ls(i,j,k) > 0._rt;
+            } else {
+                body = true;
+#if (AMREX_SPACEDIM == 3)
+                for (int kk = k-1; kk <= k; ++kk) {
+#else
+                for (int kk = k; kk <= k; ++kk) {
+#endif
+                for (int jj = j-1; jj <= j; ++jj) {
+                for (int ii = i-1; ii <= i; ++ii) {
+                    if (flag_box.contains(IntVect(AMREX_D_DECL(ii,jj,kk))) &&
+                        !flag(ii,jj,kk).isCovered()) {
+                        body = false;
+                    }
+                }}}
+            }
+            fab(i,j,k) = (body ? -fluid_sign : fluid_sign) * d(i,j,k);
+        });
+    }
+
+    mf.FillBoundary(geom.periodicity());
+}
+
 } // end namespace
@@ -488,27 +488,78 @@ void BLProfStats::ClearBlock(BLPDataBlock &dBlock) {
 }
 
 
+// ----------------------------------------------------------------------
+std::pair<int, int> BLProfStats::MyDataProcRange()
+{
+  Long nProcs(ParallelDescriptor::NProcs());
+  Long myProc(ParallelDescriptor::MyProc());
+  return std::make_pair(static_cast<int>( myProc      * dataNProcs / nProcs),
+                        static_cast<int>((myProc + 1) * dataNProcs / nProcs));
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStats::ReduceFuncStats(Vector<Vector<FuncStat> > &funcStats)
+{
+  BL_PROFILE("BLProfStats::ReduceFuncStats()");
+  // ---- each [fnum][proc] entry is only set by the rank that owns proc
+  int nFuncs(funcStats.size());
+  Vector<Long> nCalls(nFuncs * dataNProcs);
+  Vector<Real> totalTime(nFuncs * dataNProcs);
+  for(int fnum(0); fnum < nFuncs; ++fnum) {
+    for(int p(0); p < dataNProcs; ++p) {
+      nCalls[fnum * dataNProcs + p]    = funcStats[fnum][p].nCalls;
+      totalTime[fnum * dataNProcs + p] = funcStats[fnum][p].totalTime;
+    }
+  }
+
+  int ioProc(ParallelDescriptor::IOProcessorNumber());
+  ParallelDescriptor::ReduceLongSum(nCalls.dataPtr(), nCalls.size(), ioProc);
+  ParallelDescriptor::ReduceRealSum(totalTime.dataPtr(), totalTime.size(), ioProc);
+
+  if(ParallelDescriptor::IOProcessor()) {
+    for(int fnum(0); fnum < nFuncs; ++fnum) {
+      for(int p(0); p < dataNProcs; ++p) {
+        funcStats[fnum][p].nCalls    = nCalls[fnum * dataNProcs + p];
+        funcStats[fnum][p].totalTime = totalTime[fnum * dataNProcs + p];
+      }
+    }
+  }
+}
+
+
 // ----------------------------------------------------------------------
 void BLProfStats::CollectFuncStats(Vector<Vector<FuncStat> > &funcStats)
 {
+  BL_PROFILE("BLProfStats::CollectFuncStats()");
   funcStats.resize(blpFNames.size());  // [fnum][proc]
   for(int n(0); n < funcStats.size(); ++n) {
     funcStats[n].resize(dataNProcs);
   }
 
-  for(int idb(0); idb < blpDataBlocks.size(); ++idb) {
-    BLPDataBlock &dBlock = blpDataBlocks[idb];
-    ReadBlock(dBlock);
-    Vector<long> &nc = dBlock.nCalls;
-    Vector<Real> &tt = dBlock.totalTime;
-
-    for(int fnum(0); fnum < blpFNames.size(); ++fnum) {
-      FuncStat &fs = funcStats[fnum][dBlock.proc];
-      fs.nCalls = nc[fnum];
-      fs.totalTime = tt[fnum];
+  // ---- blocks for one proc stay on one thread, so the funcStats
+  // ---- updates do not conflict
+  Vector<Vector<int> > procBlocks(MyDataProcBlocks(blpDataBlocks));
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int ip = 0; ip < procBlocks.size(); ++ip) {
+    for(int idb : procBlocks[ip]) {
+      BLPDataBlock &dBlock = blpDataBlocks[idb];
+      ReadBlock(dBlock);
+      Vector<long> &nc = dBlock.nCalls;
+      Vector<Real> &tt = dBlock.totalTime;
+
+      for(int fnum(0); fnum < blpFNames.size(); ++fnum) {
+        FuncStat &fs = funcStats[fnum][dBlock.proc];
+        fs.nCalls = nc[fnum];
+        fs.totalTime = tt[fnum];
+      }
+      ClearBlock(dBlock);
     }
-    ClearBlock(dBlock);
   }
+
+  ReduceFuncStats(funcStats);
 }
 
 
@@ -516,13 +567,13 @@ void BLProfStats::CollectFuncStats(Vector<Vector<FuncStat> > &funcStats)
 void BLProfStats::WriteSummary(std::ostream &ios, bool /*bwriteavg*/,
                                int whichProc, bool graphTopPct)
 {
+  Vector<Vector<FuncStat> > funcStats;
+  CollectFuncStats(funcStats);
+
   if( ! ParallelDescriptor::IOProcessor()) {
     return;
   }
 
-  Vector<Vector<FuncStat> > funcStats;
-  CollectFuncStats(funcStats);
-
   Real calcRunTime(calcEndTime);
   BLProfiler::SetRunTime(calcRunTime);
 
@@ -636,28 +636,39 @@ void RegionsProfStats::FillAllCallTimes(Vector<Vector<Real> > &allCallTimes,
 // ----------------------------------------------------------------------
 void RegionsProfStats::CollectFuncStats(Vector<Vector<FuncStat> > &funcStats)
 {
+  BL_PROFILE("RegionsProfStats::CollectFuncStats()");
   funcStats.resize(numbersToFName.size());  // [fnum][proc]
   for(int n(0); n < funcStats.size(); ++n) {
     funcStats[n].resize(dataNProcs);
   }
 
-  for(int idb(0); idb < dataBlocks.size(); ++idb) {
-    DataBlock &dBlock = dataBlocks[idb];
-    ReadBlock(dBlock);
+  // ---- blocks for one proc stay on one thread, so the funcStats
+  // ---- updates do not conflict.  the rstartstops are not needed here.
+  Vector<Vector<int> > procBlocks(MyDataProcBlocks(dataBlocks));
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int ip = 0; ip < procBlocks.size(); ++ip) {
+    for(int idb : procBlocks[ip]) {
+      DataBlock &dBlock = dataBlocks[idb];
+      ReadBlock(dBlock, false, true);  // ------ only read trace data
 
-    for(int i(0); i < dBlock.vCallStats.size(); ++i) {
-      BLProfiler::CallStats &cs = dBlock.vCallStats[i];
-      if(cs.csFNameNumber < 0) {  // ---- the unused cs
-        continue;
-      }
-      if(InTimeRange(dBlock.proc, cs.callTime)) {
-        int remappedIndex(fnameRemap[dBlock.proc][cs.csFNameNumber]);
-        funcStats[remappedIndex][dBlock.proc].totalTime += cs.stackTime;
-        funcStats[remappedIndex][dBlock.proc].nCalls  += 1;
+      for(int i(0); i < dBlock.vCallStats.size(); ++i) {
+        BLProfiler::CallStats &cs = dBlock.vCallStats[i];
+        if(cs.csFNameNumber < 0) {  // ---- the unused cs
+          continue;
+        }
+        if(InTimeRange(dBlock.proc, cs.callTime)) {
+          int remappedIndex(fnameRemap[dBlock.proc][cs.csFNameNumber]);
+          funcStats[remappedIndex][dBlock.proc].totalTime += cs.stackTime;
+          funcStats[remappedIndex][dBlock.proc].nCalls  += 1;
+        }
       }
+      ClearBlock(dBlock);
     }
-    ClearBlock(dBlock);
   }
+
+  ReduceFuncStats(funcStats);
 }
 
 
@@ -665,13 +676,13 @@ void RegionsProfStats::CollectFuncStats(Vector<Vector<FuncStat> > &funcStats)
 void RegionsProfStats::WriteSummary(std::ostream &ios, bool /*bwriteavg*/,
                                     int whichProc, bool graphTopPct)
 {
+  Vector<Vector<FuncStat> > funcStats;  // [fnum][proc]
+  CollectFuncStats(funcStats);
+
   if( ! ParallelDescriptor::IOProcessor()) {
     return;
   }
 
-  Real timeMin(std::numeric_limits<Real>::max());
-  Real timeMax(-std::numeric_limits<Real>::max());
-
   Vector<std::string> fNames(numbersToFName.size());
   for(int i(0); i < fNames.size(); ++i) {
     if(i >= 0) {
@@ -679,48 +690,37 @@ void RegionsProfStats::WriteSummary(std::ostream &ios, bool /*bwriteavg*/,
     }
   }
 
+  // ---- the time range comes from the headers, only the blocks
+  // ---- for whichProc are read here
+  Real timeMin(std::numeric_limits<Real>::max());
+  Real timeMax(-std::numeric_limits<Real>::max());
   Vector<BLProfiler::CallStats> vCallStatsAllOneProc;
-  Vector<Vector<FuncStat> > funcStats(fNames.size());  // [fnum][proc]
-  for(int n(0); n < funcStats.size(); ++n) {
-    funcStats[n].resize(dataNProcs);
-  }
 
   for(int idb(0); idb < dataBlocks.size(); ++idb) {
     DataBlock &dBlock = dataBlocks[idb];
-    ReadBlock(dBlock);
-    if(dBlock.proc == whichProc) {
-      for(int i(0); i < dBlock.vCallStats.size(); ++i) {
-        // ---- here we have to add only the part of this
-        // ---- callstat that intersects the region time range
-        BLProfiler::CallStats &cs = dBlock.vCallStats[i];
-        TimeRange tRangeFull(cs.callTime, cs.callTime + cs.totalTime);
-        std::list<TimeRange> intersectList =
-            RegionsProfStats::RangeIntersection(filterTimeRanges[whichProc], tRangeFull);
-        std::list<TimeRange>::iterator tri;
-        for(tri = intersectList.begin(); tri != intersectList.end(); ++tri) {
-          BLProfiler::CallStats csis(dBlock.vCallStats[i]);
-          csis.callTime  = tri->startTime;
-          csis.totalTime = tri->stopTime - tri->startTime;
-          if(InTimeRange(dBlock.proc, cs.callTime)) {
-            vCallStatsAllOneProc.push_back(csis);
-          }
-        }
-      }
+    timeMin = std::min(timeMin, dBlock.timeMin);
+    timeMax = std::max(timeMax, dBlock.timeMax);
+    if(dBlock.proc != whichProc) {
+      continue;
     }
-
+    ReadBlock(dBlock, false, true);  // ------ only read trace data
     for(int i(0); i < dBlock.vCallStats.size(); ++i) {
+      // ---- here we have to add only the part of this
+      // ---- callstat that intersects the region time range
       BLProfiler::CallStats &cs = dBlock.vCallStats[i];
-      if(cs.csFNameNumber < 0) {  // ---- the unused cs
-        continue;
-      }
-      if(InTimeRange(dBlock.proc, cs.callTime)) {
-        int remappedIndex(fnameRemap[dBlock.proc][cs.csFNameNumber]);
-        funcStats[remappedIndex][dBlock.proc].totalTime += cs.stackTime;
-        funcStats[remappedIndex][dBlock.proc].nCalls  += 1;
+      TimeRange tRangeFull(cs.callTime, cs.callTime + cs.totalTime);
+      std::list<TimeRange> intersectList =
+          RegionsProfStats::RangeIntersection(filterTimeRanges[whichProc], tRangeFull);
+      std::list<TimeRange>::iterator tri;
+      for(tri = intersectList.begin(); tri != intersectList.end(); ++tri) {
+        BLProfiler::CallStats csis(dBlock.vCallStats[i]);
+        csis.callTime  = tri->startTime;
+        csis.totalTime = tri->stopTime - tri->startTime;
+        if(InTimeRange(dBlock.proc, cs.callTime)) {
+          vCallStatsAllOneProc.push_back(csis);
+        }
       }
     }
-    timeMin = std::min(timeMin, dBlock.timeMin);
-    timeMax = std::max(timeMax, dBlock.timeMax);
     ClearBlock(dBlock);
   }
 
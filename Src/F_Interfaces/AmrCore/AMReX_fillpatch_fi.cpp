@@ -16,7 +16,8 @@ namespace
         &amrex::protected_interp,        // 6
         &amrex::quartic_interp,          // 7
         &amrex::face_divfree_interp,     // 8
-        &amrex::face_linear_interp       // 9
+        &amrex::face_linear_interp,      // 9
+        &amrex::cell_cons_weno_interp    // 10
     };
 }
 
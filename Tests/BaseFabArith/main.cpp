@@ -0,0 +1,199 @@
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+
+#include <iomanip>
+
+using namespace amrex;
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Reference versions with the generic 4D loops, i.e., what BaseFab did
+// before the contiguous fast paths.
+
+void ref_copy (FArrayBox& d, FArrayBox const& s, Box const& bx, int ncomp)
+{
+    auto const& da = d.array();
+    auto const& sa = s.const_array();
+    amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        da(i,j,k,n) = sa(i,j,k,n);
+    });
+}
+
+void ref_plus (FArrayBox& d, FArrayBox const& s, Box const& bx, int ncomp)
+{
+    auto const& da = d.array();
+    auto const& sa = s.const_array();
+    amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        da(i,j,k,n) += sa(i,j,k,n);
+    });
+}
+
+void ref_mult (FArrayBox& d, FArrayBox const& s, Box const& bx, int ncomp)
+{
+    auto const& da = d.array();
+    auto const& sa = s.const_array();
+    amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        da(i,j,k,n) *= sa(i,j,k,n);
+    });
+}
+
+void ref_saxpy (FArrayBox& d, Real a, FArrayBox const& s, Box const& bx, int ncomp)
+{
+    auto const& da = d.array();
+    auto const& sa = s.const_array();
+    amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        da(i,j,k,n) += a * sa(i,j,k,n);
+    });
+}
+
+void ref_lincomb (FArrayBox& d, Real a, FArrayBox const& x, Real b, FArrayBox const& y,
+                  Box const& bx, int ncomp)
+{
+    auto const& da = d.array();
+    auto const& xa = x.const_array();
+    auto const& ya = y.const_array();
+    amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        da(i,j,k,n) = a*xa(i,j,k,n) + b*ya(i,j,k,n);
+    });
+}
+
+double diff (FArrayBox const& a, FArrayBox const& b, int ncomp)
+{
+    FArrayBox t(a.box(), ncomp);
+    t.copy<RunOn::Host>(a, 0, 0, ncomp);
+    t.minus<RunOn::Host>(b, 0, 0, ncomp);
+    return t.norm<RunOn::Host>(0, 0, ncomp);
+}
+
+}
+
+void test ()
+{
+    int n_cell = 32;
+    int ncomp = 4;
+    int nghost = 2;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("ncomp", ncomp);
+        pp.query("nghost", nghost);
+    }
+
+    const Box vbx(IntVect(0), IntVect(n_cell-1));
+    const Box gbx = amrex::grow(vbx, nghost);
+
+    FArrayBox x(gbx, ncomp), y(gbx, ncomp), d0(gbx, ncomp), d1(gbx, ncomp);
+    {
+        auto const& xa = x.array();
+        auto const& ya = y.array();
+        amrex::LoopOnCpu(gbx, ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            xa(i,j,k,n) = 1.0 + 0.001*(i + 2*j + 3*k + n);
+            ya(i,j,k,n) = 2.0 - 0.001*(3*i + j + 2*k + n);
+        });
+    }
+
+    auto check = [&] (std::string const& name, std::string const& region, double err)
+    {
+        amrex::Print() << "  " << std::left << std::setw(8) << name << std::setw(7) << region
+                       << std::right << " diff = " << err << "\n";
+        AMREX_ALWAYS_ASSERT(err == 0.0);
+    };
+
+    // The whole fab is contiguous for each component.  The valid region is
+    // not, and falls back to the generic loop.  Both must agree exactly
+    // with the reference loops.
+    for (auto const& [region, bx] : {std::make_pair(std::string("fab"), gbx),
+                                     std::make_pair(std::string("valid"), vbx)})
+    {
+        d0.copy<RunOn::Host>(y); d1.copy<RunOn::Host>(y);
+        ref_copy(d0, x, bx, ncomp);
+        d1.copy<RunOn::Host>(x, bx, SrcComp{0}, DestComp{0}, NumComps{ncomp});
+        check("copy", region, diff(d0,d1,ncomp));
+
+        d0.copy<RunOn::Host>(y); d1.copy<RunOn::Host>(y);
+        ref_plus(d0, x, bx, ncomp);
+        d1.plus<RunOn::Host>(x, bx, SrcComp{0}, DestComp{0}, NumComps{ncomp});
+        check("plus", region, diff(d0,d1,ncomp));
+
+        d0.copy<RunOn::Host>(y); d1.copy<RunOn::Host>(y);
+        ref_mult(d0, x, bx, ncomp);
+        d1.mult<RunOn::Host>(x, bx, SrcComp{0}, DestComp{0}, NumComps{ncomp});
+        check("mult", region, diff(d0,d1,ncomp));
+
+        d0.copy<RunOn::Host>(y); d1.copy<RunOn::Host>(y);
+        ref_saxpy(d0, 1.e-3, x, bx, ncomp);
+        d1.saxpy<RunOn::Host>(1.e-3, x, bx, bx, 0, 0, ncomp);
+        check("saxpy", region, diff(d0,d1,ncomp));
+
+        d0.copy<RunOn::Host>(y); d1.copy<RunOn::Host>(y);
+        ref_lincomb(d0, 0.5, x, 0.25, y, bx, ncomp);
+        d1.linComb<RunOn::Host>(x, bx, 0, y, bx, 0, 0.5, 0.25, bx, 0, ncomp);
+        check("linComb", region, diff(d0,d1,ncomp));
+    }
+
+    // MultiFab operations with and without ghost cells
+    BoxArray ba(amrex::grow(vbx, -nghost).refine(4));
+    ba.maxSize(n_cell);
+    DistributionMapping dm(ba);
+    MultiFab mx(ba, dm, ncomp, nghost), my(ba, dm, ncomp, nghost);
+    MultiFab md0(ba, dm, ncomp, nghost), md1(ba, dm, ncomp, nghost);
+    for (MFIter mfi(mx); mfi.isValid(); ++mfi) {
+        auto const& xa = mx.array(mfi);
+        auto const& ya = my.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            xa(i,j,k,n) = 1.0 + 0.001*(i + 2*j + 3*k + n);
+            ya(i,j,k,n) = 2.0 - 0.001*(3*i + j + 2*k + n);
+        });
+    }
+
+    auto mfdiff = [&] (int ng) -> double
+    {
+        MultiFab::Subtract(md1, md0, 0, 0, ncomp, ng);
+        return md1.norminf(0, ncomp, IntVect(ng));
+    };
+
+    for (int ng : {0, nghost}) {
+        const std::string region = "ng=" + std::to_string(ng);
+
+        md0.setVal(0.0); md1.setVal(0.0);
+        for (MFIter mfi(md0); mfi.isValid(); ++mfi) {
+            ref_copy(md0[mfi], mx[mfi], mfi.growntilebox(ng), ncomp);
+        }
+        MultiFab::Copy(md1, mx, 0, 0, ncomp, ng);
+        check("Copy", region, mfdiff(ng));
+
+        MultiFab::Copy(md0, my, 0, 0, ncomp, nghost);
+        MultiFab::Copy(md1, my, 0, 0, ncomp, nghost);
+        for (MFIter mfi(md0); mfi.isValid(); ++mfi) {
+            ref_saxpy(md0[mfi], 1.e-3, mx[mfi], mfi.growntilebox(ng), ncomp);
+        }
+        MultiFab::Saxpy(md1, 1.e-3, mx, 0, 0, ncomp, ng);
+        check("Saxpy", region, mfdiff(ng));
+
+        md0.setVal(0.0); md1.setVal(0.0);
+        for (MFIter mfi(md0); mfi.isValid(); ++mfi) {
+            ref_lincomb(md0[mfi], 0.5, mx[mfi], 0.25, my[mfi], mfi.growntilebox(ng), ncomp);
+        }
+        MultiFab::LinComb(md1, 0.5, mx, 0, 0.25, my, 0, 0, ncomp, ng);
+        check("LinComb", region, mfdiff(ng));
+    }
+}
@@ -0,0 +1,110 @@
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_Loop.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+// Antiderivatives of the test profiles in one direction
+Real quartic (Real x) { return x + x*x/2 - x*x*x + x*x*x*x/4 + Real(0.3)*x*x*x*x*x; }
+Real linear  (Real x) { return x + Real(1.5)*x*x; }
+Real step    (Real x) { return (x < Real(0.43)) ? x : Real(3.)*x - Real(0.86); }
+
+// Cell average of F'(x)F'(y)F'(z) over the cells of bx with spacing dx
+template <typename F>
+void fill_averages (FArrayBox& fab, Real dx, F const& F_)
+{
+    auto const& a = fab.array();
+    amrex::LoopOnCpu(fab.box(), [&] (int i, int j, int k)
+    {
+        Real v = 1.;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int ii = (idim == 0) ? i : ((idim == 1) ? j : k);
+            v *= (F_((ii+1)*dx) - F_(ii*dx)) / dx;
+        }
+        a(i,j,k) = v;
+    });
+}
+
+Real max_diff (FArrayBox const& a, FArrayBox const& b, Box const& bx)
+{
+    Real r = 0.;
+    auto const& aa = a.const_array();
+    auto const& ba = b.const_array();
+    amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+    {
+        r = std::max(r, std::abs(aa(i,j,k)-ba(i,j,k)));
+    });
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const Box cdomain(IntVect(0), IntVect(15));
+        const Real cdx = Real(1.)/16;
+        Geometry cgeom(cdomain, RealBox(AMREX_D_DECL(0.,0.,0.),AMREX_D_DECL(1.,1.,1.)), 0,
+                       {AMREX_D_DECL(0,0,0)});
+        Vector<BCRec> bcr(1, BCRec(AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::int_dir),
+                                   AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::int_dir)));
+
+        CellConservativeWENO weno_linear(false);
+
+        for (int r : {2, 4})
+        {
+            const IntVect ratio(r);
+            const Box fine_region = amrex::refine(Box(IntVect(4), IntVect(11)), ratio);
+            const Real fdx = cdx / r;
+            Geometry fgeom = amrex::refine(cgeom, ratio);
+
+            const Box cbx = cell_cons_weno_interp.CoarseBox(fine_region, ratio);
+            AMREX_ALWAYS_ASSERT(cdomain.contains(cbx));
+            FArrayBox crse(cbx, 1), fine(fine_region, 1), exact(fine_region, 1);
+
+            // With the linear weights, polynomials of degree 4 are exact.
+            fill_averages(crse, cdx, quartic);
+            fill_averages(exact, fdx, quartic);
+            weno_linear.interp(crse, 0, fine, 0, 1, fine_region, ratio, cgeom, fgeom,
+                               bcr, 0, 0, RunOn::Host);
+            Real err = max_diff(fine, exact, fine_region);
+            amrex::Print() << "ratio " << r << ": quartic, linear weights, error " << err << "\n";
+            AMREX_ALWAYS_ASSERT(err < Real(1.e-10));
+
+            // The WENO-Z weights are optimal for linear data.
+            fill_averages(crse, cdx, linear);
+            fill_averages(exact, fdx, linear);
+            cell_cons_weno_interp.interp(crse, 0, fine, 0, 1, fine_region, ratio, cgeom, fgeom,
+                                         bcr, 0, 0, RunOn::Host);
+            err = max_diff(fine, exact, fine_region);
+            amrex::Print() << "ratio " << r << ": linear, WENO weights, error " << err << "\n";
+            AMREX_ALWAYS_ASSERT(err < Real(1.e-12));
+
+            // Across a jump the fine averages still add up to the coarse ones.
+            fill_averages(crse, cdx, step);
+            cell_cons_weno_interp.interp(crse, 0, fine, 0, 1, fine_region, ratio, cgeom, fgeom,
+                                         bcr, 0, 0, RunOn::Host);
+            FArrayBox avg(amrex::coarsen(fine_region, ratio), 1);
+            avg.setVal<RunOn::Host>(0.);
+            auto const& aa = avg.array();
+            auto const& fa = fine.const_array();
+            amrex::LoopOnCpu(fine_region, [&] (int i, int j, int k)
+            {
+                aa(amrex::coarsen(IntVect(AMREX_D_DECL(i,j,k)), ratio))
+                    += fa(i,j,k) / Real(AMREX_D_TERM(r,*r,*r));
+            });
+            err = max_diff(avg, crse, avg.box());
+            amrex::Print() << "ratio " << r << ": jump, WENO weights, conservation error " << err << "\n";
+            AMREX_ALWAYS_ASSERT(err < Real(1.e-12));
+        }
+    }
+    amrex::Finalize();
+}
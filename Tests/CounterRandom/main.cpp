@@ -0,0 +1,61 @@
+#include <AMReX.H>
+#include <AMReX_CounterRandom.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        // Known-answer vectors of Philox4x32-10 from Random123 (kat_vectors)
+        struct KAT {
+            GpuArray<std::uint32_t,4> ctr;
+            GpuArray<std::uint32_t,2> key;
+            GpuArray<std::uint32_t,4> out;
+        };
+        const KAT kats[] = {
+            {{0x00000000U, 0x00000000U, 0x00000000U, 0x00000000U},
+             {0x00000000U, 0x00000000U},
+             {0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U}},
+            {{0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU},
+             {0xffffffffU, 0xffffffffU},
+             {0x408f276dU, 0x41c83b0eU, 0xa20bc7c6U, 0x6d5451fdU}},
+            {{0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U},
+             {0xa4093822U, 0x299f31d0U},
+             {0xd16cfe09U, 0x94fdccebU, 0x5001e420U, 0x24126ea1U}}
+        };
+        for (auto const& kat : kats) {
+            const auto out = Philox4x32(kat.ctr, kat.key);
+            for (int n = 0; n < 4; ++n) {
+                AMREX_ALWAYS_ASSERT(out[n] == kat.out[n]);
+            }
+        }
+        amrex::Print() << "Philox4x32-10 known-answer tests passed\n";
+
+        // The values do not depend on the box decomposition.
+        const Box domain(IntVect(0), IntVect(31));
+        const CounterRandom rng{12345, 7};
+        MultiFab mf[2];
+        int n = 0;
+        for (int max_grid_size : {32, 8}) {
+            BoxArray ba(domain);
+            ba.maxSize(max_grid_size);
+            mf[n].define(ba, DistributionMapping(ba), 1, 0);
+            FillRandom(mf[n], 0, 1, rng);
+            ++n;
+        }
+        MultiFab tmp(mf[1].boxArray(), mf[1].DistributionMap(), 1, 0);
+        tmp.ParallelCopy(mf[0]);
+        MultiFab::Subtract(tmp, mf[1], 0, 0, 1, 0);
+        AMREX_ALWAYS_ASSERT(tmp.norminf() == 0.);
+
+        const Real mean = mf[0].sum() / Real(domain.numPts());
+        amrex::Print() << "mean of uniform numbers " << mean << "\n";
+        AMREX_ALWAYS_ASSERT(std::abs(mean - Real(0.5)) < Real(0.01));
+        AMREX_ALWAYS_ASSERT(mf[0].min(0) >= Real(0.) && mf[0].max(0) < Real(1.));
+    }
+    amrex::Finalize();
+}
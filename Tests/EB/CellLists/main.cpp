@@ -0,0 +1,118 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBCellLists.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+using namespace amrex;
+
+namespace {
+
+// Number of cells whose visit counts are wrong: non-covered cells must be
+// visited once, by the regular kernel only if they are regular, and
+// covered cells never.
+Long num_wrong (iMultiFab const& nreg, iMultiFab const& nirreg,
+                FabArray<EBCellFlagFab> const& flags)
+{
+    auto const& ra = nreg.const_arrays();
+    auto const& ia = nirreg.const_arrays();
+    auto const& fa = flags.const_arrays();
+    Long r = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Long>{}, nreg, IntVect(0),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) -> GpuTuple<Long>
+    {
+        const int nr = ra[box_no](i,j,k);
+        const int ni = ia[box_no](i,j,k);
+        const EBCellFlag f = fa[box_no](i,j,k);
+        bool ok;
+        if (f.isCovered()) {
+            ok = (nr == 0 && ni == 0);
+        } else if (f.isRegular()) {
+            ok = (nr + ni == 1);
+        } else {
+            ok = (nr == 0 && ni == 1);
+        }
+        return { ok ? 0 : 1 };
+    });
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// EBParallelFor must visit every non-covered cell exactly once and never
+// visit covered cells, with and without tiling and for different minimum
+// widths of the regular boxes.
+void test ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+    EB2::BoxIF cube({AMREX_D_DECL(0.35,0.35,0.1)}, {AMREX_D_DECL(0.65,0.65,0.9)}, false);
+    auto gshop = EB2::makeShop(EB2::makeUnion(sphere, cube));
+    EB2::Build(gshop, geom, 0, 0);
+
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    auto factory = makeEBFabFactory(geom, ba, dm, {1,1,1}, EBSupport::basic);
+    auto const& flags = factory->getMultiEBCellFlagFab();
+
+    iMultiFab nreg(ba, dm, 1, 0);
+    iMultiFab nirreg(ba, dm, 1, 0);
+
+    for (bool tiling : {false, true}) {
+        for (int min_width : {1, 4}) {
+            MFItInfo info;
+            if (tiling) { info.EnableTiling(IntVect(AMREX_D_DECL(16,8,8))); }
+            EBCellLists lists(flags, info, min_width);
+
+            nreg.setVal(0);
+            nirreg.setVal(0);
+            for (MFIter mfi(nreg, info); mfi.isValid(); ++mfi) {
+                auto const& r = nreg.array(mfi);
+                auto const& ir = nirreg.array(mfi);
+                EBParallelFor(lists, mfi,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    Gpu::Atomic::AddNoRet(&r(i,j,k), 1);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    Gpu::Atomic::AddNoRet(&ir(i,j,k), 1);
+                });
+            }
+            Gpu::streamSynchronize();
+
+            Long nboxes = lists.numRegularBoxes();
+            ParallelDescriptor::ReduceLongSum(nboxes);
+            AMREX_ALWAYS_ASSERT(nboxes > ba.size());
+            AMREX_ALWAYS_ASSERT(num_wrong(nreg, nirreg, flags) == 0);
+        }
+    }
+
+    amrex::Print() << "EBParallelFor on " << ParallelDescriptor::NProcs()
+                   << " process(es) passed\n";
+}
@@ -0,0 +1,131 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+using namespace amrex;
+
+namespace {
+
+// Max |a-b| over the valid and ghost cells
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrowVect());
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norminf(n, a.nGrow()));
+    }
+    return r;
+}
+
+// Regular and covered cells get values that cannot be confused with
+// those of cut cells.
+Real max_diff (MultiCutFab const& a, MultiCutFab const& b)
+{
+    return max_diff(a.ToMultiFab(-7.0, -9.0), b.ToMultiFab(-7.0, -9.0));
+}
+
+Long num_diff (FabArray<EBCellFlagFab> const& a, FabArray<EBCellFlagFab> const& b)
+{
+    auto const& aa = a.const_arrays();
+    auto const& ba = b.const_arrays();
+    Long r = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Long>{}, a, a.nGrowVect(),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) -> GpuTuple<Long>
+    {
+        return { (aa[box_no](i,j,k) == ba[box_no](i,j,k)) ? 0 : 1 };
+    });
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+Long num_sign_diff (MultiFab const& a, MultiFab const& b)
+{
+    auto const& aa = a.const_arrays();
+    auto const& ba = b.const_arrays();
+    Long r = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Long>{}, a, a.nGrowVect(),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) -> GpuTuple<Long>
+    {
+        const Real x = aa[box_no](i,j,k);
+        const Real y = ba[box_no](i,j,k);
+        return { ((x < 0.0_rt) == (y < 0.0_rt) && (x > 0.0_rt) == (y > 0.0_rt)) ? 0 : 1 };
+    });
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// The EB of two spheres is written in the compact checkpoint format and
+// read back.  The data must be identical to those of the direct build,
+// except for the level set, of which only the sign is kept away from the
+// cut cells.
+void test ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int write_chkpt = 1;
+    std::string chkpt_file("eb_chk");
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("write_chkpt", write_chkpt);
+        pp.query("chkpt_file", chkpt_file);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    EB2::SphereIF big(0.3, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+    EB2::SphereIF small(0.15, {AMREX_D_DECL(0.15,0.85,0.2)}, false);
+    auto gshop = EB2::makeShop(EB2::makeUnion(big, small));
+    EB2::Build(gshop, geom, 0, 0);
+    EB2::Level const& direct = EB2::IndexSpace::top().getLevel(geom);
+
+    if (write_chkpt) {
+        direct.write_to_chkpt_file(chkpt_file, EB2::ExtendDomainFace(), EB2::max_grid_size, true);
+    }
+
+    EB2::BuildFromChkptFile(chkpt_file, geom, 0, 0);
+    EB2::Level const& restarted = EB2::IndexSpace::top().getLevel(geom);
+
+    AMREX_ALWAYS_ASSERT(!direct.isAllRegular() && !restarted.isAllRegular());
+
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    const Vector<int> ng{2,2,2};
+    auto fa = makeEBFabFactory(&direct, ba, dm, ng, EBSupport::full);
+    auto fb = makeEBFabFactory(&restarted, ba, dm, ng, EBSupport::full);
+
+    AMREX_ALWAYS_ASSERT(num_diff(fa->getMultiEBCellFlagFab(), fb->getMultiEBCellFlagFab()) == 0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa->getVolFrac(), fb->getVolFrac()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa->getCentroid(), fb->getCentroid()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa->getBndryArea(), fb->getBndryArea()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa->getBndryCent(), fb->getBndryCent()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa->getBndryNormal(), fb->getBndryNormal()) == 0.0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        AMREX_ALWAYS_ASSERT(max_diff(*fa->getAreaFrac()[idim], *fb->getAreaFrac()[idim]) == 0.0);
+        AMREX_ALWAYS_ASSERT(max_diff(*fa->getFaceCent()[idim], *fb->getFaceCent()[idim]) == 0.0);
+        AMREX_ALWAYS_ASSERT(max_diff(*fa->getEdgeCent()[idim], *fb->getEdgeCent()[idim]) == 0.0);
+    }
+    AMREX_ALWAYS_ASSERT(num_sign_diff(fa->getLevelSet(), fb->getLevelSet()) == 0);
+
+    amrex::Print() << "EB2::ChkptFile compact round trip on " << ParallelDescriptor::NProcs()
+                   << " process(es) passed\n";
+}
@@ -0,0 +1,147 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+using namespace amrex;
+
+namespace {
+
+// Max |a-b| over the valid and ghost cells
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrowVect());
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norminf(n, a.nGrow()));
+    }
+    return r;
+}
+
+// Regular and covered cells get values that cannot be confused with
+// those of cut cells.
+Real max_diff (MultiCutFab const& a, MultiCutFab const& b)
+{
+    return max_diff(a.ToMultiFab(-7.0, -9.0), b.ToMultiFab(-7.0, -9.0));
+}
+
+// The neighbor information of covered cells depends on how the level was
+// split into boxes, so two covered cells are considered equal.
+Long num_diff (FabArray<EBCellFlagFab> const& a, FabArray<EBCellFlagFab> const& b)
+{
+    auto const& aa = a.const_arrays();
+    auto const& ba = b.const_arrays();
+    Long r = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Long>{}, a, a.nGrowVect(),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) -> GpuTuple<Long>
+    {
+        EBCellFlag fa = aa[box_no](i,j,k);
+        EBCellFlag fb = ba[box_no](i,j,k);
+        return { (fa == fb || (fa.isCovered() && fb.isCovered())) ? 0 : 1 };
+    });
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+void compare (EBFArrayBoxFactory const& fa, EBFArrayBoxFactory const& fb)
+{
+    AMREX_ALWAYS_ASSERT(num_diff(fa.getMultiEBCellFlagFab(), fb.getMultiEBCellFlagFab()) == 0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa.getVolFrac(), fb.getVolFrac()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa.getCentroid(), fb.getCentroid()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa.getBndryArea(), fb.getBndryArea()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa.getBndryCent(), fb.getBndryCent()) == 0.0);
+    AMREX_ALWAYS_ASSERT(max_diff(fa.getBndryNormal(), fb.getBndryNormal()) == 0.0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        AMREX_ALWAYS_ASSERT(max_diff(*fa.getAreaFrac()[idim], *fb.getAreaFrac()[idim]) == 0.0);
+        AMREX_ALWAYS_ASSERT(max_diff(*fa.getFaceCent()[idim], *fb.getFaceCent()[idim]) == 0.0);
+    }
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// Fine levels added with build_on_demand are built on the regions of a
+// few BoxArrays, one after the other as after regrids, and compared with
+// levels built on the whole domain.
+void test ()
+{
+    int n_cell = 32;
+    int nlev = 2;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("nlev", nlev);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    const Geometry fgeom = amrex::refine(geom, 1<<nlev);
+    const Geometry mgeom = amrex::refine(geom, 2);
+
+    EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+    EB2::BoxIF cube({AMREX_D_DECL(0.35,0.35,0.1)}, {AMREX_D_DECL(0.65,0.65,0.9)}, false);
+    auto gshop = EB2::makeShop(EB2::makeUnion(sphere, cube));
+
+    EB2::Build(gshop, geom, 0, 0);
+    EB2::addFineLevels(nlev, true);
+    EB2::IndexSpace const* on_demand = EB2::TopIndexSpace();
+
+    // Nothing is built yet, so the level cannot claim to be all regular.
+    AMREX_ALWAYS_ASSERT(!on_demand->getLevel(fgeom).isAllRegular());
+
+    EB2::Build(gshop, fgeom, 0, 0);
+    EB2::IndexSpace const* full = EB2::TopIndexSpace();
+    EB2::Build(gshop, mgeom, 0, 0);
+    EB2::IndexSpace const* full_m = EB2::TopIndexSpace();
+
+    const int N = n_cell << nlev;
+    const Vector<int> ng{5,5,5};
+
+    // A region crossing the sphere and the cube, then the same region and
+    // one at the bottom of the cube, as after a regrid.
+    Box b1(IntVect(AMREX_D_DECL(N/8, N/2-N/16, N/2-N/16)),
+           IntVect(AMREX_D_DECL(N/4+N/16-1, N/2+N/16-1, N/2+N/16-1)));
+    Box b2(IntVect(AMREX_D_DECL(N/2-N/16, N/2-N/16, 0)),
+           IntVect(AMREX_D_DECL(N/2+N/16-1, N/2+N/16-1, N/8-1)));
+    BoxArray ba1(b1);
+    ba1.maxSize(32);
+    BoxArray ba2(BoxList(Vector<Box>{b1,b2}));
+    ba2.maxSize(32);
+    // Inside the cube, and at the low x domain boundary
+    BoxArray ba3(Box(IntVect(N/2-8), IntVect(N/2+7)));
+    BoxArray ba4(Box(IntVect(AMREX_D_DECL(0,N/2-16,N/2-16)),
+                     IntVect(AMREX_D_DECL(15,N/2+15,N/2+15))));
+
+    for (BoxArray const& ba : {ba1, ba2, ba3, ba4}) {
+        DistributionMapping dm(ba);
+        auto fa = makeEBFabFactory(on_demand, fgeom, ba, dm, ng, EBSupport::full);
+        auto fb = makeEBFabFactory(full, fgeom, ba, dm, ng, EBSupport::full);
+        AMREX_ALWAYS_ASSERT(!fa->isAllRegular());
+        compare(*fa, *fb);
+    }
+
+    // An intermediate level
+    if (nlev > 1) {
+        BoxArray ba = amrex::coarsen(ba2, 1<<(nlev-1));
+        DistributionMapping dm(ba);
+        auto fa = makeEBFabFactory(on_demand, mgeom, ba, dm, ng, EBSupport::full);
+        auto fb = makeEBFabFactory(full_m, mgeom, ba, dm, ng, EBSupport::full);
+        compare(*fa, *fb);
+    }
+
+    amrex::Print() << "EB2 on-demand levels on " << ParallelDescriptor::NProcs()
+                   << " process(es) passed\n";
+}
@@ -0,0 +1,141 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EB_utils.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+using namespace amrex;
+
+namespace {
+
+struct Errors
+{
+    Real max_err = 0.0;  // max |d - exact| where |exact| is in the band
+    Real mean_err = 0.0; // mean |d - exact| where |exact| is in the band
+    Long num_sign = 0;   // number of nodes with a wrong sign
+    Long num_clamp = 0;  // number of nodes outside the band that are not clamped
+    Real max_abs = 0.0;  // max |d|
+};
+
+// The fluid is outside the sphere, so the exact signed distance is
+// |x-center|-radius.  Nodes within a cell of the band edge are only
+// checked for the sign.
+Errors check (MultiFab const& mf, Geometry const& geom, Real radius,
+              GpuArray<Real,AMREX_SPACEDIM> const& center, int nband)
+{
+    auto const& problo = geom.ProbLoArray();
+    auto const& dx = geom.CellSizeArray();
+    const Real h = dx[0];
+    const Real band = nband * h;
+    auto const& ma = mf.const_arrays();
+    auto r = ParReduce(TypeList<ReduceOpMax,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpMax>{},
+                       TypeList<Real,Real,Long,Long,Long,Real>{}, mf, IntVect(0),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k)
+        -> GpuTuple<Real,Real,Long,Long,Long,Real>
+    {
+        const Real x = problo[0] + i*dx[0] - center[0];
+        const Real y = problo[1] + j*dx[1] - center[1];
+        const Real z = problo[2] + k*dx[2] - center[2];
+        const Real exact = std::sqrt(x*x + y*y + z*z) - radius;
+        const Real d = ma[box_no](i,j,k);
+        Real err = 0.0;
+        Long nin = 0;
+        Long nsign = 0;
+        Long nclamp = 0;
+        if (std::abs(exact) < band - h) {
+            err = std::abs(d - exact);
+            nin = 1;
+        }
+        if (std::abs(exact) > h && (d > 0.0_rt) != (exact > 0.0_rt)) {
+            nsign = 1;
+        }
+        if (std::abs(exact) > band + h && std::abs(d) != band) {
+            nclamp = 1;
+        }
+        return {err, err, nin, nsign, nclamp, std::abs(d)};
+    });
+
+    Real max_err = amrex::get<0>(r);
+    Real sum_err = amrex::get<1>(r);
+    Long n[3] = {amrex::get<2>(r), amrex::get<3>(r), amrex::get<4>(r)};
+    Real max_abs = amrex::get<5>(r);
+    ParallelDescriptor::ReduceRealMax(max_err);
+    ParallelDescriptor::ReduceRealMax(max_abs);
+    ParallelDescriptor::ReduceRealSum(sum_err);
+    ParallelDescriptor::ReduceLongSum(n, 3);
+
+    AMREX_ALWAYS_ASSERT(n[0] > 0);
+    return Errors{max_err/h, sum_err/(h*Real(n[0])), n[1], n[2], max_abs/h};
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// FillSignedDistanceNarrowBand on a sphere is compared with the exact
+// distance in the band.  EBDataCollection::getSignedDistance must give
+// the same result and recompute it when nband changes.
+void test ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int nband = 4;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nband", nband);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    const Real radius = 0.31;
+    const GpuArray<Real,AMREX_SPACEDIM> center{AMREX_D_DECL(0.49,0.52,0.5)};
+    EB2::SphereIF sphere(radius, {AMREX_D_DECL(center[0],center[1],center[2])}, false);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 0, 0);
+
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    auto factory = makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+
+    MultiFab dist(amrex::convert(ba, IntVect::TheNodeVector()), dm, 1, 1);
+    FillSignedDistanceNarrowBand(dist, *factory, nband);
+
+    auto e = check(dist, geom, radius, center, nband);
+    amrex::Print() << "nband " << nband << ": max error " << e.max_err << " dx, mean error "
+                   << e.mean_err << " dx\n";
+    AMREX_ALWAYS_ASSERT(e.max_err < 0.25_rt && e.mean_err < 0.05_rt);
+    AMREX_ALWAYS_ASSERT(e.num_sign == 0 && e.num_clamp == 0);
+    AMREX_ALWAYS_ASSERT(e.max_abs == Real(nband));
+
+    // The cached distance is the same, and it is recomputed for a
+    // different band.
+    MultiFab const& d1 = factory->getSignedDistance(nband);
+    MultiFab::Subtract(dist, d1, 0, 0, 1, 0);
+    AMREX_ALWAYS_ASSERT(dist.norminf(0) == 0.0);
+
+    MultiFab const& d2 = factory->getSignedDistance(nband/2);
+    auto e2 = check(d2, geom, radius, center, nband/2);
+    AMREX_ALWAYS_ASSERT(e2.max_abs == Real(nband/2) && e2.num_clamp == 0 && e2.num_sign == 0);
+
+    MultiFab const& d3 = factory->getSignedDistance(nband);
+    auto e3 = check(d3, geom, radius, center, nband);
+    AMREX_ALWAYS_ASSERT(e3.max_abs == Real(nband) && e3.max_err == e.max_err);
+
+    amrex::Print() << "FillSignedDistanceNarrowBand on " << ParallelDescriptor::NProcs()
+                   << " process(es) passed\n";
+}
@@ -0,0 +1,226 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EB_StateRedistributor.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+using namespace amrex;
+
+namespace {
+
+// Smooth functions of the cell centers, also in covered and ghost cells
+void fill (MultiFab& mf, Geometry const& geom, Real a)
+{
+    auto const& problo = geom.ProbLoArray();
+    auto const& dx = geom.CellSizeArray();
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, mf.nGrowVect(), mf.nComp(),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        const Real x = problo[0] + (i+0.5_rt)*dx[0];
+        const Real y = problo[1] + (j+0.5_rt)*dx[1];
+        const Real z = problo[2] + (k+0.5_rt)*dx[2];
+        ma[box_no](i,j,k,n) = a*(n+1) + std::sin(2.0_rt*x + n) * std::cos(3.0_rt*y) + z*z;
+    });
+    Gpu::streamSynchronize();
+}
+
+// The EB data are only defined for boxes with cut cells nearby.  As in
+// applications calling ApplyRedistribution, the other boxes are skipped.
+bool is_regular_or_covered (FabArray<EBCellFlagFab> const& flags, MFIter const& mfi)
+{
+    const FabType t = flags[mfi].getType(amrex::grow(mfi.validbox(),4));
+    return t == FabType::regular || t == FabType::covered;
+}
+
+// Max |a-b| over the valid cells
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), 0);
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norminf(n));
+    }
+    return r;
+}
+
+// Max vfrac*|a-b| over the valid cells.  The round-off errors of
+// redistribution are those of vfrac times the state, so they are much
+// larger than those of the state itself in small cells.
+Real max_weighted_diff (MultiFab const& a, MultiFab const& b, MultiFab const& vfrac)
+{
+    auto const& aa = a.const_arrays();
+    auto const& ba = b.const_arrays();
+    auto const& va = vfrac.const_arrays();
+    const int ncomp = a.nComp();
+    Real r = ParReduce(TypeList<ReduceOpMax>{}, TypeList<Real>{}, a, IntVect(0),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) -> GpuTuple<Real>
+    {
+        Real d = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            d = amrex::max(d, std::abs(aa[box_no](i,j,k,n) - ba[box_no](i,j,k,n)));
+        }
+        return { va[box_no](i,j,k) * d };
+    });
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// EBStateRedistributor must give the same results as calling
+// ApplyRedistribution with "StateRedist" and ApplyInitialRedistribution
+// on each box.  apply sums the terms in a different order, so it agrees
+// up to round-off (relative to the volume fraction).  applyInitial does the same operations on the same
+// data, so it must agree exactly.
+void test ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    Geometry geom(Box(IntVect(0), IntVect(n_cell-1)),
+                  RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                  CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    EB2::SphereIF sphere(0.31, {AMREX_D_DECL(0.49,0.52,0.5)}, true);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 0, 0);
+
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    auto factory = makeEBFabFactory(geom, ba, dm, {5,5,5}, EBSupport::full);
+
+    const int ncomp = 2;
+    const Real dt = 0.1;
+
+    Vector<BCRec> h_bcrec(ncomp);
+    for (auto& bc : h_bcrec) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, BCType::foextrap);
+            bc.setHi(idim, BCType::foextrap);
+        }
+    }
+    Gpu::DeviceVector<BCRec> d_bcrec(ncomp);
+    Gpu::copyAsync(Gpu::hostToDevice, h_bcrec.begin(), h_bcrec.end(), d_bcrec.begin());
+
+    MultiFab U(ba, dm, ncomp, 3, MFInfo(), *factory);
+    MultiFab dUdt_a(ba, dm, ncomp, 3, MFInfo(), *factory);
+    MultiFab dUdt_b(ba, dm, ncomp, 3, MFInfo(), *factory);
+    fill(U, geom, 1.0);
+    fill(dUdt_a, geom, -2.0);
+    fill(dUdt_b, geom, -2.0);
+
+    EBStateRedistributor redist(geom, *factory);
+    {
+        // Both boxes with and without cut cells must be tested.
+        int ncut = redist.numCutBoxes();
+        ParallelDescriptor::ReduceIntSum(ncut);
+        AMREX_ALWAYS_ASSERT(ncut > 0 && ncut < ba.size());
+    }
+
+    auto const& flags = factory->getMultiEBCellFlagFab();
+    auto const& vfrac = factory->getVolFrac();
+    auto const& ccent = factory->getCentroid();
+    auto const& area = factory->getAreaFrac();
+    auto const& fcent = factory->getFaceCent();
+
+    // apply
+    {
+        MultiFab out_a(ba, dm, ncomp, 0, MFInfo(), *factory);
+        MultiFab out_b(ba, dm, ncomp, 0, MFInfo(), *factory);
+
+        redist.apply(out_a, dUdt_a, U, 0, ncomp, dt, d_bcrec.data());
+
+        for (MFIter mfi(out_b); mfi.isValid(); ++mfi) {
+            Box const& bx = mfi.validbox();
+            if (is_regular_or_covered(flags, mfi)) {
+                out_b[mfi].copy<RunOn::Device>(dUdt_b[mfi], bx);
+                continue;
+            }
+            FArrayBox scratch(amrex::grow(bx,3), ncomp, The_Async_Arena());
+            ApplyRedistribution(bx, ncomp, out_b.array(mfi), dUdt_b.array(mfi),
+                                U.const_array(mfi), scratch.array(), flags.const_array(mfi),
+                                AMREX_D_DECL(area[0]->const_array(mfi),
+                                             area[1]->const_array(mfi),
+                                             area[2]->const_array(mfi)),
+                                vfrac.const_array(mfi),
+                                AMREX_D_DECL(fcent[0]->const_array(mfi),
+                                             fcent[1]->const_array(mfi),
+                                             fcent[2]->const_array(mfi)),
+                                ccent.const_array(mfi), d_bcrec.data(), geom, dt,
+                                "StateRedist");
+        }
+
+        Real scale = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            scale = std::max(scale, out_b.norminf(n));
+        }
+        const Real err = max_weighted_diff(out_a, out_b, vfrac);
+        amrex::Print() << "apply: max vfrac*|difference| = " << err
+                       << ", max |dUdt| = " << scale << "\n";
+        AMREX_ALWAYS_ASSERT(err <= 1.e-13_rt * scale);
+    }
+
+    // applyInitial
+    {
+        MultiFab U_a(ba, dm, ncomp, 3, MFInfo(), *factory);
+        MultiFab U_b(ba, dm, ncomp, 3, MFInfo(), *factory);
+        MultiFab::Copy(U_a, U, 0, 0, ncomp, 3);
+        MultiFab::Copy(U_b, U, 0, 0, ncomp, 3);
+
+        MultiFab out_a(ba, dm, ncomp, 0, MFInfo(), *factory);
+        MultiFab out_b(ba, dm, ncomp, 0, MFInfo(), *factory);
+
+        redist.applyInitial(out_a, U_a, 0, ncomp, d_bcrec.data());
+
+        for (MFIter mfi(out_b); mfi.isValid(); ++mfi) {
+            if (is_regular_or_covered(flags, mfi)) {
+                auto const& out = out_b.array(mfi);
+                auto const& uin = U_b.const_array(mfi);
+                auto const& flag = flags.const_array(mfi);
+                ParallelFor(mfi.validbox(), ncomp,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                {
+                    out(i,j,k,n) = flag(i,j,k).isCovered() ? Real(1.e30) : uin(i,j,k,n);
+                });
+                continue;
+            }
+            ApplyInitialRedistribution(mfi.validbox(), ncomp, out_b.array(mfi), U_b.array(mfi),
+                                       flags.const_array(mfi),
+                                       AMREX_D_DECL(area[0]->const_array(mfi),
+                                                    area[1]->const_array(mfi),
+                                                    area[2]->const_array(mfi)),
+                                       vfrac.const_array(mfi),
+                                       AMREX_D_DECL(fcent[0]->const_array(mfi),
+                                                    fcent[1]->const_array(mfi),
+                                                    fcent[2]->const_array(mfi)),
+                                       ccent.const_array(mfi), d_bcrec.data(), geom,
+                                       "StateRedist");
+        }
+
+        AMREX_ALWAYS_ASSERT(max_diff(out_a, out_b) == 0.0);
+    }
+
+    amrex::Print() << "EBStateRedistributor on " << ParallelDescriptor::NProcs()
+                   << " process(es) passed\n";
+}
@@ -0,0 +1,108 @@
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+void fill_mf (MultiFab& mf, Geometry const& geom)
+{
+    auto const& dx = geom.CellSizeArray();
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+                [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n)
+    {
+        AMREX_D_TERM(Real x = (i+Real(0.5))*dx[0];,
+                     Real y = (j+Real(0.5))*dx[1];,
+                     Real z = (k+Real(0.5))*dx[2];)
+        ma[b](i,j,k,n) = Real(n+1) * (AMREX_D_TERM(std::sin(Real(6.3)*x),
+                                                    + Real(2.)*y*y,
+                                                    + std::cos(Real(3.1)*z)));
+    });
+    Gpu::streamSynchronize();
+}
+
+// Fills fine ghost cells and the uncovered part of the fine level with
+// the requested interpolater, optionally using the fused path.
+void fill_two_levels (MultiFab& dst, MultiFab& crse, MultiFab& fine,
+                      Geometry const& cgeom, Geometry const& fgeom,
+                      IntVect const& ratio, Interpolater* mapper, bool fused)
+{
+    FabArrayBase::fillpatch_fused_interp = fused;
+
+    dst.setVal(Real(-1.0));
+
+    PhysBCFunctNoOp bc;
+    Vector<BCRec> bcs(dst.nComp(), BCRec(AMREX_D_DECL(BCType::int_dir,
+                                                      BCType::foextrap,
+                                                      BCType::foextrap),
+                                         AMREX_D_DECL(BCType::int_dir,
+                                                      BCType::foextrap,
+                                                      BCType::foextrap)));
+
+    FillPatchTwoLevels(dst, dst.nGrowVect(), Real(0.0),
+                       {&crse}, {Real(0.0)}, {&fine}, {Real(0.0)},
+                       0, 0, dst.nComp(), cgeom, fgeom,
+                       bc, 0, bc, 0, ratio, mapper, bcs, 0);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        const int ncomp = 2;
+        const IntVect ratio(2);
+        const int ng = 2;
+
+        Box cdomain(IntVect(0), IntVect(31));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,0)};
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(16);
+        MultiFab crse(cba, DistributionMapping{cba}, ncomp, 0);
+        fill_mf(crse, cgeom);
+
+        // A fine level that touches the periodic boundary and leaves gaps
+        // between its boxes, so that both ghost cells and valid cells of
+        // the destination need coarse data.
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(AMREX_D_DECL( 0, 8, 8)), IntVect(AMREX_D_DECL(23,31,31))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(40, 8, 8)), IntVect(AMREX_D_DECL(63,39,31))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(24,40,16)), IntVect(AMREX_D_DECL(47,55,39))));
+        BoxArray fba(std::move(fbl));
+        fba.maxSize(16);
+        DistributionMapping fdm(fba);
+        MultiFab fine(fba, fdm, ncomp, 0);
+        fill_mf(fine, fgeom);
+
+        // The destination also covers cells that the source fine level
+        // does not, as a regridded level would.
+        BoxArray dba(Box(IntVect(AMREX_D_DECL(0,4,4)), IntVect(AMREX_D_DECL(63,47,47))));
+        dba.maxSize(16);
+        DistributionMapping ddm(dba);
+        MultiFab dst_default(dba, ddm, ncomp, ng);
+        MultiFab dst_fused  (dba, ddm, ncomp, ng);
+
+        for (Interpolater* mapper : {static_cast<Interpolater*>(&pc_interp),
+                                     static_cast<Interpolater*>(&cell_cons_interp),
+                                     static_cast<Interpolater*>(&quartic_interp)})
+        {
+            fill_two_levels(dst_default, crse, fine, cgeom, fgeom, ratio, mapper, false);
+            fill_two_levels(dst_fused  , crse, fine, cgeom, fgeom, ratio, mapper, true);
+
+            MultiFab::Subtract(dst_fused, dst_default, 0, 0, ncomp, ng);
+            Real diff = dst_fused.norminf(0, ncomp, IntVect(ng));
+            amrex::Print() << "max |fused - default| = " << diff << "\n";
+            AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,111 @@
+#include <AMReX.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_InSitu.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <fstream>
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+
+void fill (MultiFab& mf, int step)
+{
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, mf.nGrowVect(), mf.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+    {
+        ma[b](i,j,k,n) = std::sin(Real(0.1)*(i+1) + Real(0.2)*(j+step) + Real(0.3)*k)
+            * Real(n+1) + Real(step);
+    });
+    Gpu::streamSynchronize();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        {
+            // A single analysis rank with boxes that differ from the
+            // simulation's.
+            ParmParse pp("insitu");
+            pp.add("nranks", 1);
+            pp.add("max_grid_size", 8);
+        }
+
+        const std::string filename("insitu_stats.txt");
+        if (ParallelDescriptor::IOProcessor() && FileSystem::Exists(filename)) {
+            FileSystem::Remove(filename);
+        }
+        ParallelDescriptor::Barrier();
+
+        Box domain(IntVect(0), IntVect(31));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        MultiFab mf(ba, DistributionMapping{ba}, 3, 1);
+
+        // Only the first two components are analyzed.
+        const Vector<std::string> varnames{"a", "b"};
+        const int ncomp = static_cast<int>(varnames.size());
+        const int nsteps = 3;
+
+        Vector<Vector<Real>> expected(nsteps);
+        {
+            InSitu::Pipeline insitu;
+            insitu.addOperator("stats", InSitu::Reductions(filename));
+            for (int step = 0; step < nsteps; ++step) {
+                fill(mf, step);
+                for (int n = 0; n < ncomp; ++n) {
+                    expected[step].push_back(mf.min(n));
+                    expected[step].push_back(mf.max(n));
+                    expected[step].push_back(mf.sum(n) / Real(domain.d_numPts()));
+                }
+                insitu.submit(mf, geom, varnames, step, Real(step)*Real(0.5));
+                // The copy is still in flight, but mf can be modified.
+                mf.setVal(Real(-1.e10));
+            }
+            insitu.finish();
+        }
+        ParallelDescriptor::Barrier();
+
+        if (ParallelDescriptor::IOProcessor()) {
+            std::ifstream ifs(filename);
+            AMREX_ALWAYS_ASSERT(ifs.good());
+            std::string line;
+            int nlines = 0;
+            while (std::getline(ifs, line)) {
+                if (line.empty() || line[0] == '#') { continue; }
+                std::istringstream is(line);
+                int step;
+                Real time;
+                is >> step >> time;
+                AMREX_ALWAYS_ASSERT(step == nlines && time == Real(step)*Real(0.5));
+                for (int m = 0; m < 3*ncomp; ++m) {
+                    Real v;
+                    is >> v;
+                    const Real e = expected[step][m];
+                    amrex::Print() << "step " << step << " value " << m << ": "
+                                   << v << " expected " << e << "\n";
+                    // min and max are exact; the means are summed in a
+                    // different order.
+                    if (m % 3 == 2) {
+                        AMREX_ALWAYS_ASSERT(std::abs(v-e) <= Real(1.e-12)*(Real(1.)+std::abs(e)));
+                    } else {
+                        AMREX_ALWAYS_ASSERT(v == e);
+                    }
+                }
+                ++nlines;
+            }
+            AMREX_ALWAYS_ASSERT(nlines == nsteps);
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,410 @@
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Utility.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+#include <AMReX_ParticleInterpolators.H>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+struct Result
+{
+    std::string name;
+    int n_cell;
+    int nboxes;
+    Long work;  // cells or particles processed per iteration
+    double tmin, tavg, tmax;
+};
+
+// Each iteration is timed on the slowest rank.  setup() runs before every
+// iteration and is not timed.
+template <typename S, typename F>
+Result timeit (std::string const& name, int n_cell, int nboxes, Long work,
+               int nwarmup, int niters, S&& setup, F&& f)
+{
+    for (int i = 0; i < nwarmup; ++i) {
+        setup();
+        f();
+    }
+    Gpu::streamSynchronize();
+
+    Vector<double> t(niters);
+    for (int i = 0; i < niters; ++i) {
+        setup();
+        Gpu::streamSynchronize();
+        ParallelDescriptor::Barrier();
+        double t0 = amrex::second();
+        f();
+        Gpu::streamSynchronize();
+        t[i] = amrex::second() - t0;
+    }
+    ParallelDescriptor::ReduceRealMax(t.data(), niters);
+
+    Result r{name, n_cell, nboxes, work, t[0], 0.0, t[0]};
+    for (auto x : t) {
+        r.tmin = std::min(r.tmin, x);
+        r.tmax = std::max(r.tmax, x);
+        r.tavg += x;
+    }
+    r.tavg /= niters;
+
+    amrex::Print() << "  " << std::left << std::setw(20) << name << std::right
+                   << std::setw(8) << n_cell << std::setw(8) << nboxes
+                   << std::scientific << std::setprecision(4)
+                   << std::setw(14) << r.tmin << std::setw(14) << r.tavg
+                   << std::setw(14) << r.tmax << std::defaultfloat << "\n";
+    return r;
+}
+
+void write_json (std::string const& file, Vector<Result> const& results,
+                 int max_grid_size, int ncomp, int nghost, int ref_ratio, int nppc,
+                 int nwarmup, int niters)
+{
+    if (!ParallelDescriptor::IOProcessor()) { return; }
+
+    std::ofstream ofs(file);
+    ofs << std::setprecision(9);
+    ofs << "{\n"
+        << "  \"amrex_version\": \"" << amrex::Version() << "\",\n"
+        << "  \"spacedim\": " << AMREX_SPACEDIM << ",\n"
+        << "  \"nranks\": " << ParallelDescriptor::NProcs() << ",\n"
+        << "  \"nthreads\": " << OpenMP::get_max_threads() << ",\n"
+        << "  \"gpu\": " << (Gpu::inLaunchRegion() ? "true" : "false") << ",\n"
+        << "  \"real_size\": " << sizeof(Real) << ",\n"
+        << "  \"max_grid_size\": " << max_grid_size << ",\n"
+        << "  \"ncomp\": " << ncomp << ",\n"
+        << "  \"nghost\": " << nghost << ",\n"
+        << "  \"ref_ratio\": " << ref_ratio << ",\n"
+        << "  \"nppc\": " << nppc << ",\n"
+        << "  \"nwarmup\": " << nwarmup << ",\n"
+        << "  \"niters\": " << niters << ",\n"
+        << "  \"benchmarks\": [\n";
+    for (int i = 0; i < results.size(); ++i) {
+        auto const& r = results[i];
+        ofs << "    {\"name\": \"" << r.name << "\", \"n_cell\": " << r.n_cell
+            << ", \"nboxes\": " << r.nboxes << ", \"work\": " << r.work
+            << ", \"min\": " << r.tmin << ", \"mean\": " << r.tavg
+            << ", \"max\": " << r.tmax << "}"
+            << ((i+1 < results.size()) ? ",\n" : "\n");
+    }
+    ofs << "  ]\n"
+        << "}\n";
+}
+
+}
+
+void main_main ()
+{
+    Vector<int> n_cells{64};
+    int max_grid_size = 32;
+    int ncomp = 4;
+    int nghost = 2;
+    int ref_ratio = 2;
+    int nppc = 2;
+    int nwarmup = 2;
+    int niters = 10;
+    Vector<std::string> kernels{"FillBoundary", "ParallelCopy", "MFIterTiling",
+                                "Saxpy", "LinComb", "Dot", "AverageDown", "FillPatchTwoLevels", "MLMGVCycle",
+                                "Redistribute", "Deposition", "VisMFWrite", "VisMFRead"};
+    std::string output = "kernel_benchmarks.json";
+    std::string vismf_dir = "kernel_benchmarks_vismf";
+    {
+        ParmParse pp("bench");
+        pp.queryarr("n_cell", n_cells);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("ncomp", ncomp);
+        pp.query("nghost", nghost);
+        pp.query("ref_ratio", ref_ratio);
+        pp.query("nppc", nppc);
+        pp.query("nwarmup", nwarmup);
+        pp.query("niters", niters);
+        pp.queryarr("kernels", kernels);
+        pp.query("output", output);
+        pp.query("vismf_dir", vismf_dir);
+    }
+
+    auto enabled = [&] (std::string const& name) {
+        return std::find(kernels.begin(), kernels.end(), name) != kernels.end();
+    };
+
+    amrex::Print() << "# nranks = " << ParallelDescriptor::NProcs()
+                   << ", nthreads = " << OpenMP::get_max_threads()
+                   << ", max_grid_size = " << max_grid_size << ", ncomp = " << ncomp
+                   << ", nghost = " << nghost << "\n"
+                   << "# kernel               n_cell  nboxes      min (s)      mean (s)"
+                   << "       max (s)\n";
+
+    Vector<Result> results;
+
+    for (int n_cell : n_cells)
+    {
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        const Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+        const int nboxes = static_cast<int>(ba.size());
+        const Long ncells = domain.numPts();
+
+        MultiFab src(ba, dm, ncomp, nghost);
+        MultiFab dst(ba, dm, ncomp, nghost);
+        {
+            const auto problo = geom.ProbLoArray();
+            const auto dx = geom.CellSizeArray();
+            auto const& ma = src.arrays();
+            ParallelFor(src, IntVect(nghost), ncomp,
+            [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+            {
+                AMREX_D_TERM(Real x = problo[0] + (i+0.5)*dx[0];,
+                             Real y = problo[1] + (j+0.5)*dx[1];,
+                             Real z = problo[2] + (k+0.5)*dx[2];)
+                ma[b](i,j,k,n) = Real(1.0) + Real(n)
+                    + AMREX_D_TERM(std::sin(Real(2.*3.1415926535897932)*x),
+                                  * std::sin(Real(2.*3.1415926535897932)*y),
+                                  * std::sin(Real(2.*3.1415926535897932)*z));
+            });
+            Gpu::streamSynchronize();
+        }
+
+        auto noop = [] () {};
+
+        if (enabled("FillBoundary")) {
+            results.push_back(timeit("FillBoundary", n_cell, nboxes, ncells, nwarmup, niters,
+                                     noop, [&] () { src.FillBoundary(geom.periodicity()); }));
+        }
+
+        if (enabled("ParallelCopy")) {
+            // Copy into pencils, e.g., what a transpose for FFTs does.
+            IntVect pencil(max_grid_size);
+            pencil[0] = n_cell;
+            BoxArray ba2(domain);
+            ba2.maxSize(pencil);
+            DistributionMapping dm2(ba2);
+            MultiFab dst2(ba2, dm2, ncomp, 0);
+            results.push_back(timeit("ParallelCopy", n_cell, nboxes, ncells, nwarmup, niters,
+                                     noop, [&] () {
+                                         dst2.ParallelCopy(src, 0, 0, ncomp, IntVect(0),
+                                                           IntVect(0), geom.periodicity());
+                                     }));
+        }
+
+        if (enabled("MFIterTiling")) {
+            // 2*SPACEDIM+1 point stencil over tiles
+            src.FillBoundary(geom.periodicity());
+            results.push_back(timeit("MFIterTiling", n_cell, nboxes, ncells, nwarmup, niters,
+                                     noop, [&] () {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+                for (MFIter mfi(dst, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+                    const Box& bx = mfi.tilebox();
+                    auto const& s = src.const_array(mfi);
+                    auto const& d = dst.array(mfi);
+                    ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                    {
+                        d(i,j,k,n) = Real(-2*AMREX_SPACEDIM)*s(i,j,k,n)
+                            + AMREX_D_TERM(s(i-1,j,k,n) + s(i+1,j,k,n),
+                                         + s(i,j-1,k,n) + s(i,j+1,k,n),
+                                         + s(i,j,k-1,n) + s(i,j,k+1,n));
+                    });
+                }
+            }));
+        }
+
+        // Vector operations of the linear solvers.  Each sweeps the valid
+        // and ghost cells of all components.
+        if (enabled("Saxpy")) {
+            results.push_back(timeit("Saxpy", n_cell, nboxes, ncells, nwarmup, niters,
+                                     [&] () { dst.setVal(0.0); }, [&] () {
+                                         MultiFab::Saxpy(dst, 1.e-3, src, 0, 0, ncomp, nghost);
+                                     }));
+        }
+
+        if (enabled("LinComb")) {
+            results.push_back(timeit("LinComb", n_cell, nboxes, ncells, nwarmup, niters,
+                                     noop, [&] () {
+                                         MultiFab::LinComb(dst, 0.5, src, 0, 0.25, src, 0, 0,
+                                                           ncomp, nghost);
+                                     }));
+        }
+
+        if (enabled("Dot")) {
+            Real r = 0.0;
+            results.push_back(timeit("Dot", n_cell, nboxes, ncells, nwarmup, niters,
+                                     noop, [&] () {
+                                         r += MultiFab::Dot(src, 0, src, 0, ncomp, nghost);
+                                     }));
+            amrex::ignore_unused(r);
+        }
+
+        if (enabled("AverageDown")) {
+            MultiFab fine(amrex::refine(ba,ref_ratio), dm, ncomp, 0);
+            fine.setVal(1.0);
+            results.push_back(timeit("AverageDown", n_cell, nboxes, ncells, nwarmup, niters,
+                                     noop, [&] () {
+                                         amrex::average_down(fine, dst, 0, ncomp, ref_ratio);
+                                     }));
+        }
+
+        if (enabled("FillPatchTwoLevels")) {
+            // The fine level covers the central half of the domain in each direction.
+            const Geometry fgeom(amrex::refine(domain,ref_ratio), rb, CoordSys::cartesian,
+                                 is_periodic);
+            BoxArray fba(amrex::refine(amrex::grow(domain,-n_cell/4), ref_ratio));
+            fba.maxSize(max_grid_size);
+            DistributionMapping fdm(fba);
+            MultiFab fsrc(fba, fdm, ncomp, 0);
+            MultiFab fdst(fba, fdm, ncomp, nghost);
+            fsrc.setVal(1.0);
+
+            Vector<BCRec> bcs(ncomp);
+            for (auto& bc : bcs) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    bc.setLo(idim, BCType::int_dir);
+                    bc.setHi(idim, BCType::int_dir);
+                }
+            }
+            PhysBCFunctNoOp cbc, fbc;
+            results.push_back(timeit("FillPatchTwoLevels", n_cell, static_cast<int>(fba.size()),
+                                     fba.numPts(), nwarmup, niters, noop, [&] () {
+                FillPatchTwoLevels(fdst, IntVect(nghost), 0.0, {&src}, {0.0}, {&fsrc}, {0.0},
+                                   0, 0, ncomp, geom, fgeom, cbc, 0, fbc, 0,
+                                   IntVect(ref_ratio), &cell_cons_interp, bcs, 0);
+            }));
+        }
+
+        if (enabled("MLMGVCycle")) {
+            MultiFab phi(ba, dm, 1, 1);
+            MultiFab rhs(ba, dm, 1, 0);
+            MultiFab::Copy(rhs, src, 0, 0, 1, 0);
+            rhs.plus(-1.0, 0, 1);  // zero mean for the periodic problem
+
+            MLPoisson mlpoisson({geom}, {ba}, {dm});
+            mlpoisson.setDomainBC({AMREX_D_DECL(LinOpBCType::Periodic,
+                                                LinOpBCType::Periodic,
+                                                LinOpBCType::Periodic)},
+                                  {AMREX_D_DECL(LinOpBCType::Periodic,
+                                                LinOpBCType::Periodic,
+                                                LinOpBCType::Periodic)});
+            mlpoisson.setLevelBC(0, nullptr);
+            MLMG mlmg(mlpoisson);
+            mlmg.setVerbose(0);
+            mlmg.setFixedIter(1);
+            results.push_back(timeit("MLMGVCycle", n_cell, nboxes, ncells, nwarmup, niters,
+                                     [&] () { phi.setVal(0.0); },
+                                     [&] () { mlmg.solve({&phi}, {&rhs}, 1.e-10, 0.0); }));
+        }
+
+        if (enabled("Redistribute") || enabled("Deposition")) {
+            using PC = ParticleContainer<1+AMREX_SPACEDIM, 0>;
+            PC pc(geom, dm, ba);
+            PC::ParticleInitData pdata = {{AMREX_D_DECL(1.0, 0.0, 0.0), 1.0}, {}, {}, {}};
+            pc.InitNRandomPerCell(nppc, pdata);
+            const Long np = pc.TotalNumberOfParticles();
+
+            if (enabled("Redistribute")) {
+                // Move each particle randomly by up to one cell before every
+                // Redistribute.
+                auto move = [&] () {
+                    const auto dx = geom.CellSizeArray();
+                    for (int lev = 0; lev <= pc.finestLevel(); ++lev) {
+                        for (auto& kv : pc.GetParticles(lev)) {
+                            auto* pstruct = kv.second.GetArrayOfStructs().data();
+                            const auto n = kv.second.numParticles();
+                            ParallelForRNG(n,
+                            [=] AMREX_GPU_DEVICE (int i, RandomEngine const& engine) noexcept
+                            {
+                                auto& p = pstruct[i];
+                                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                                    p.pos(idim) += static_cast<ParticleReal>
+                                        ((Real(2.)*amrex::Random(engine)-Real(1.))*dx[idim]);
+                                }
+                            });
+                        }
+                    }
+                };
+                results.push_back(timeit("Redistribute", n_cell, nboxes, np, nwarmup, niters,
+                                         move, [&] () { pc.Redistribute(); }));
+            }
+
+            if (enabled("Deposition")) {
+                // Cloud-in-cell deposition of the particle mass
+                MultiFab rho(ba, dm, 1, 1);
+                const auto plo = geom.ProbLoArray();
+                const auto dxi = geom.InvCellSizeArray();
+                results.push_back(timeit("Deposition", n_cell, nboxes, np, nwarmup, niters,
+                                         [&] () { rho.setVal(0.0); }, [&] () {
+                    amrex::ParticleToMesh(pc, rho, 0,
+                        [=] AMREX_GPU_DEVICE (const PC::SuperParticleType& p,
+                                              Array4<Real> const& rho_arr)
+                        {
+                            ParticleInterpolator::Linear interp(p, plo, dxi);
+                            interp.ParticleToMesh(p, rho_arr, AMREX_SPACEDIM, 0, 1,
+                                [=] AMREX_GPU_DEVICE (const PC::SuperParticleType& part, int comp)
+                                {
+                                    return part.rdata(comp);
+                                });
+                        });
+                }));
+            }
+        }
+
+        if (enabled("VisMFWrite") || enabled("VisMFRead")) {
+            const std::string prefix = vismf_dir + "/mf_" + std::to_string(n_cell);
+            if (ParallelDescriptor::IOProcessor()) {
+                amrex::UtilCreateCleanDirectory(vismf_dir, false);
+            }
+            ParallelDescriptor::Barrier();
+
+            if (enabled("VisMFWrite")) {
+                results.push_back(timeit("VisMFWrite", n_cell, nboxes, ncells, nwarmup, niters,
+                                         noop, [&] () { VisMF::Write(src, prefix); }));
+            } else {
+                VisMF::Write(src, prefix);
+            }
+            if (enabled("VisMFRead")) {
+                MultiFab mf;
+                results.push_back(timeit("VisMFRead", n_cell, nboxes, ncells, nwarmup, niters,
+                                         [&] () { mf.clear(); },
+                                         [&] () { VisMF::Read(mf, prefix); }));
+            }
+
+            ParallelDescriptor::Barrier();
+            if (ParallelDescriptor::IOProcessor()) {
+                FileSystem::RemoveAll(vismf_dir);
+            }
+        }
+    }
+
+    write_json(output, results, max_grid_size, ncomp, nghost, ref_ratio, nppc,
+               nwarmup, niters);
+    amrex::Print() << "# results written to " << output << "\n";
+}
@@ -0,0 +1,157 @@
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+
+#include <iomanip>
+
+using namespace amrex;
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Fused kernels with the number of components known only at run time,
+// i.e., what the FabArray utilities did before they were specialized.
+
+void rt_saxpy (MultiFab& y, Real a, MultiFab const& x, int ncomp, IntVect const& nghost)
+{
+    auto const& yma = y.arrays();
+    auto const& xma = x.const_arrays();
+    ParallelFor(y, nghost, ncomp,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+    {
+        yma[box_no](i,j,k,n) += a * xma[box_no](i,j,k,n);
+    });
+    Gpu::streamSynchronize();
+}
+
+Real rt_dot (MultiFab const& x, MultiFab const& y, int ncomp, IntVect const& nghost)
+{
+    auto const& xma = x.const_arrays();
+    auto const& yma = y.const_arrays();
+    return ParReduce(TypeList<ReduceOpSum>{}, TypeList<Real>{}, x, nghost,
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept -> GpuTuple<Real>
+    {
+        Real t = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            t += xma[box_no](i,j,k,n) * yma[box_no](i,j,k,n);
+        }
+        return t;
+    });
+}
+
+// Same kernels with the number of components as a compile time option
+
+void cto_saxpy (MultiFab& y, Real a, MultiFab const& x, int ncomp, IntVect const& nghost)
+{
+    auto const& yma = y.arrays();
+    auto const& xma = x.const_arrays();
+    AnyCTO(TypeList<amrex::detail::NCompOptions>{}, {amrex::detail::NCompOption(ncomp)},
+    [&] (auto cto_func) { ParallelFor(y, nghost, cto_func); },
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, auto nc_ctrl) noexcept
+    {
+        constexpr int NC = nc_ctrl.value;
+        const int nc = (NC > 0) ? NC : ncomp;
+        for (int n = 0; n < nc; ++n) {
+            yma[box_no](i,j,k,n) += a * xma[box_no](i,j,k,n);
+        }
+    });
+    Gpu::streamSynchronize();
+}
+
+Real cto_dot (MultiFab const& x, MultiFab const& y, int ncomp, IntVect const& nghost)
+{
+    auto const& xma = x.const_arrays();
+    auto const& yma = y.const_arrays();
+    Real r = 0.0;
+    AnyCTO(TypeList<amrex::detail::NCompOptions>{}, {amrex::detail::NCompOption(ncomp)},
+    [&] (auto cto_func) {
+        r = ParReduce(TypeList<ReduceOpSum>{}, TypeList<Real>{}, x, nghost, cto_func);
+    },
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, auto nc_ctrl) noexcept
+        -> GpuTuple<Real>
+    {
+        constexpr int NC = nc_ctrl.value;
+        const int nc = (NC > 0) ? NC : ncomp;
+        Real t = 0.0;
+        for (int n = 0; n < nc; ++n) {
+            t += xma[box_no](i,j,k,n) * yma[box_no](i,j,k,n);
+        }
+        return t;
+    });
+    return r;
+}
+
+}
+
+void test ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int nghost = 1;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nghost", nghost);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    const IntVect ng(nghost);
+
+    amrex::Print() << "# n_cell = " << n_cell << ", max_grid_size = " << max_grid_size
+                   << ", nghost = " << nghost << "\n"
+                   << "# ncomp   saxpy diff   Saxpy diff   dot rel. diff   Dot rel. diff\n";
+
+    // Components 1 to 6 use the compile time versions; 7 falls back to
+    // the run time loop.
+    for (int ncomp = 1; ncomp <= 7; ++ncomp) {
+        MultiFab x(ba, dm, ncomp, nghost), y0(ba, dm, ncomp, nghost);
+        MultiFab y1(ba, dm, ncomp, nghost), y2(ba, dm, ncomp, nghost);
+        auto const& xma = x.arrays();
+        auto const& yma = y0.arrays();
+        ParallelFor(x, ng, ncomp,
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+        {
+            xma[box_no](i,j,k,n) = 1.0 + 0.001*(i + 2*j + 3*k + n);
+            yma[box_no](i,j,k,n) = 2.0 - 0.001*(3*i + j + 2*k + n);
+        });
+        MultiFab::Copy(y1, y0, 0, 0, ncomp, nghost);
+        MultiFab::Copy(y2, y0, 0, 0, ncomp, nghost);
+
+        // The same arithmetic for each cell, so the results must agree
+        // exactly.
+        rt_saxpy(y0, 1.e-3, x, ncomp, ng);
+        cto_saxpy(y1, 1.e-3, x, ncomp, ng);
+        MultiFab::Saxpy(y2, 1.e-3, x, 0, 0, ncomp, ng);
+        MultiFab::Subtract(y1, y0, 0, 0, ncomp, nghost);
+        MultiFab::Subtract(y2, y0, 0, 0, ncomp, nghost);
+        Real ds1 = y1.norminf(0, ncomp, ng);
+        Real ds2 = y2.norminf(0, ncomp, ng);
+
+        // The order of the sums may differ.  All of these are local sums.
+        Real d0 = rt_dot(x, y0, ncomp, ng);
+        Real d1 = cto_dot(x, y0, ncomp, ng);
+        Real d2 = MultiFab::Dot(x, 0, y0, 0, ncomp, nghost, true);
+        Real dd1 = std::abs(d1-d0)/std::abs(d0);
+        Real dd2 = std::abs(d2-d0)/std::abs(d0);
+
+        amrex::Print() << std::setw(7) << ncomp
+                       << std::setw(13) << ds1 << std::setw(13) << ds2
+                       << std::setw(16) << dd1 << std::setw(16) << dd2 << "\n";
+
+        AMREX_ALWAYS_ASSERT(ds1 == 0.0 && ds2 == 0.0);
+        AMREX_ALWAYS_ASSERT(dd1 < 1.e-12 && dd2 < 1.e-12);
+    }
+}
@@ -0,0 +1,98 @@
+#include <AMReX.H>
+#include <AMReX_MPMD.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real value (int i, int j, int k, int n, int step) noexcept
+{
+    return Real(i + 100*j + 10000*k + 1000000*n + step);
+}
+
+// Max error of components [icomp,icomp+ncomp) compared to factor*value
+Real max_error (MultiFab const& mf, int icomp, int ncomp, Real factor, int step)
+{
+    auto const& ma = mf.const_arrays();
+    Real r = ParReduce(TypeList<ReduceOpMax>{}, TypeList<Real>{}, mf, IntVect(0), ncomp,
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) -> GpuTuple<Real>
+    {
+        return { std::abs(ma[b](i,j,k,icomp+n) - factor*value(i,j,k,icomp+n,step)) };
+    });
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+}
+
+void test ();
+
+// Run as two programs, e.g., mpiexec -n 2 ./a.out : -n 1 ./a.out
+int main (int argc, char* argv[])
+{
+    MPI_Comm comm = MPMD::Initialize(argc, argv);
+    amrex::Initialize(argc,argv,true,comm);
+    test();
+    amrex::Finalize();
+    MPMD::Finalize();
+}
+
+// Program 0 sends two components of a MultiFab with send_nowait and
+// overwrites them before send_finish.  Program 1, which has different
+// boxes, doubles them and sends them back the same way.
+void test ()
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(MPMD::NProcs() > ParallelDescriptor::NProcs(),
+                                     "This test must be run as two programs");
+
+    const int prog = MPMD::MyProgId();
+    const int ncomp = 4;
+    const int icomp = 1;
+    const int nc = 2;
+
+    BoxArray ba(Box(IntVect(0), IntVect(31)));
+    ba.maxSize((prog == 0) ? 8 : 16);
+    DistributionMapping dm(ba);
+    MultiFab mf(ba, dm, ncomp, 1);
+    MPMD::Copier copier(ba, dm);
+
+    for (int step = 0; step < 3; ++step) {
+        if (prog == 0) {
+            auto const& ma = mf.arrays();
+            ParallelFor(mf, IntVect(0), ncomp,
+                        [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n)
+            {
+                ma[b](i,j,k,n) = value(i,j,k,n,step);
+            });
+            Gpu::streamSynchronize();
+
+            copier.send_nowait(mf, icomp, nc);
+            // The data have been packed.
+            mf.setVal(-1.0, icomp, nc);
+            copier.send_finish();
+
+            copier.recv_nowait(mf, icomp, nc);
+            copier.recv_finish(mf);
+
+            AMREX_ALWAYS_ASSERT(max_error(mf, icomp, nc, 2.0, step) == 0.0);
+            AMREX_ALWAYS_ASSERT(max_error(mf, 0, 1, 1.0, step) == 0.0);
+            AMREX_ALWAYS_ASSERT(max_error(mf, icomp+nc, ncomp-icomp-nc, 1.0, step) == 0.0);
+        } else {
+            mf.setVal(0.0);
+            copier.recv_nowait(mf, icomp, nc);
+            copier.recv_finish(mf);
+
+            AMREX_ALWAYS_ASSERT(max_error(mf, icomp, nc, 1.0, step) == 0.0);
+            AMREX_ALWAYS_ASSERT(max_error(mf, 0, 1, 0.0, step) == 0.0);
+
+            mf.mult(2.0, icomp, nc);
+            copier.send_nowait(mf, icomp, nc);
+            copier.send_finish();
+        }
+    }
+
+    amrex::Print() << "MPMD nowait round trip passed on program " << prog << "\n";
+}
@@ -0,0 +1,134 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_NonLocalBC.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real src_value (int i, int j, int k, int n, int field) noexcept
+{
+    return Real((field == 0) ? 1 : -1) * Real(i + 100*j + 10000*k + 1000000*n);
+}
+
+void fill_src (MultiFab& mf, int field)
+{
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+                [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n)
+    {
+        ma[b](i,j,k,n) = src_value(i,j,k,n,field);
+    });
+    Gpu::streamSynchronize();
+}
+
+// Max |a-b| over the valid and ghost cells
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrowVect());
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norminf(n, a.nGrow()));
+    }
+    return r;
+}
+
+// Max error of the valid cells of dest, which are mapped by dtos into the
+// source block.
+Real max_error (MultiFab const& dest, int field, NonLocalBC::MultiBlockIndexMapping const& dtos)
+{
+    auto const& ma = dest.const_arrays();
+    Real r = ParReduce(TypeList<ReduceOpMax>{}, TypeList<Real>{}, dest, IntVect(0), dest.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) -> GpuTuple<Real>
+    {
+        Dim3 s = dtos(Dim3{i,j,k});
+        return { std::abs(ma[b](i,j,k,n) - src_value(s.x,s.y,s.z,n,field)) };
+    });
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// Two fields of a block are filled from another block in one fused
+// ParallelCopy.  The result must be the same as that of copying them one
+// by one, and the meta data must be built only once.
+void test ()
+{
+    const Box dest_domain(IntVect(0), IntVect(31));
+    const Box src_domain = amrex::shift(dest_domain, 0, 64);
+
+    BoxArray dest_ba(dest_domain);
+    dest_ba.maxSize(8);
+    DistributionMapping dest_dm(dest_ba);
+    BoxArray src_ba(src_domain);
+    src_ba.maxSize(16);
+    DistributionMapping src_dm(src_ba);
+
+    // The first two directions are swapped.
+    NonLocalBC::MultiBlockIndexMapping dtos;
+    dtos.permutation = IntVect(AMREX_D_DECL(1,0,2));
+    dtos.offset = IntVect(AMREX_D_DECL(-64,0,0));
+    AMREX_ALWAYS_ASSERT(NonLocalBC::Image(dtos, dest_domain) == src_domain);
+
+    const int ncomp[2] = {2, 3};
+    Vector<MultiFab> src(2), dest(2), dest_ref(2);
+    for (int f = 0; f < 2; ++f) {
+        src[f].define(src_ba, src_dm, ncomp[f], 0);
+        fill_src(src[f], f);
+        dest[f].define(dest_ba, dest_dm, ncomp[f], 1);
+        dest_ref[f].define(dest_ba, dest_dm, ncomp[f], 1);
+        dest_ref[f].setVal(-1.0);
+        NonLocalBC::ParallelCopy(dest_ref[f], dest_domain, src[f], 0, 0, ncomp[f], IntVect(0), dtos);
+    }
+
+    const Long nbuild = FabArrayBase::m_MBCPC_stats.nbuild;
+    const Long nuse = FabArrayBase::m_MBCPC_stats.nuse;
+
+    const int nsteps = 3;
+    FabArrayBase::CommMetaData const* first_cmd = nullptr;
+    for (int step = 0; step < nsteps; ++step) {
+        auto const& cmd = NonLocalBC::GetMultiBlockCommMetaData(dest[0], dest_domain, src[0],
+                                                                 IntVect(0), dtos);
+        if (step == 0) {
+            first_cmd = &cmd;
+        } else {
+            AMREX_ALWAYS_ASSERT(&cmd == first_cmd);
+        }
+
+        for (auto& mf : dest) {
+            mf.setVal(-1.0);
+        }
+        NonLocalBC::ParallelCopy(Vector<MultiFab*>{&dest[0], &dest[1]},
+                                 Vector<MultiFab const*>{&src[0], &src[1]}, cmd, dtos);
+
+        for (int f = 0; f < 2; ++f) {
+            AMREX_ALWAYS_ASSERT(max_diff(dest[f], dest_ref[f]) == 0.0);
+            AMREX_ALWAYS_ASSERT(max_error(dest[f], f, dtos) == 0.0);
+        }
+    }
+
+    AMREX_ALWAYS_ASSERT(FabArrayBase::m_MBCPC_stats.nbuild == nbuild+1);
+    AMREX_ALWAYS_ASSERT(FabArrayBase::m_MBCPC_stats.nuse == nuse+nsteps);
+
+    // The meta data go away with the FabArrays.
+    src.clear();
+    dest.clear();
+    dest_ref.clear();
+    AMREX_ALWAYS_ASSERT(FabArrayBase::m_TheMBCPCache.empty());
+
+    amrex::Print() << "Fused multi-block ParallelCopy passed\n";
+}
@@ -0,0 +1,160 @@
+#include <AMReX.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_ProbeSet.H>
+
+#include <cstdint>
+#include <fstream>
+
+using namespace amrex;
+
+namespace {
+
+// Linear field, so that the cell values are those at the cell centers
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real field (IntVect const& iv, int n, int step, GpuArray<Real,AMREX_SPACEDIM> const& problo,
+            GpuArray<Real,AMREX_SPACEDIM> const& dx) noexcept
+{
+    const Real coef[] = {AMREX_D_DECL(Real(2.), Real(3.), Real(5.))};
+    Real r = Real(1.);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        r += coef[idim] * (problo[idim] + (iv[idim]+Real(0.5))*dx[idim]);
+    }
+    return Real(n+1) * Real(step+1) * r;
+}
+
+void fill (MultiFab& mf, Geometry const& geom, int step)
+{
+    auto const& problo = geom.ProbLoArray();
+    auto const& dx = geom.CellSizeArray();
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+                [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n)
+    {
+        ma[b](i,j,k,n) = field(IntVect(AMREX_D_DECL(i,j,k)), n, step, problo, dx);
+    });
+    Gpu::streamSynchronize();
+}
+
+}
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+// A plane, a line and a point are sampled on two levels, of which the
+// fine one covers only the center of the domain.  The samples in the file
+// must be the values of the finest level covering them.
+void test ()
+{
+    const std::string filename("probes.bin");
+    const int ncomp = 3;
+    const int scomp = 1;
+    const int nsteps = 3;
+
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry cgeom(Box(IntVect(0), IntVect(15)), rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    const IntVect ratio(2);
+    Geometry fgeom = amrex::refine(cgeom, ratio);
+
+    BoxArray cba(cgeom.Domain());
+    cba.maxSize(4);
+    BoxArray fba(Box(IntVect(8), IntVect(23)));
+    fba.maxSize(8);
+    MultiFab cmf(cba, DistributionMapping(cba), ncomp, 0);
+    MultiFab fmf(fba, DistributionMapping(fba), ncomp, 0);
+
+    if (ParallelDescriptor::IOProcessor()) {
+        FileSystem::Remove(filename);
+    }
+    ParallelDescriptor::Barrier();
+
+    ProbeSet probes(filename, scomp, {"u", "v"});
+    probes.addPlane("plane", AMREX_SPACEDIM-1, Real(0.6));
+    probes.addLine("line", 0, RealVect(AMREX_D_DECL(Real(0.5), Real(0.6), Real(0.6))));
+    probes.addPoint("point", RealVect(AMREX_D_DECL(Real(0.1), Real(0.1), Real(0.1))));
+
+    for (int step = 0; step < nsteps; ++step) {
+        fill(cmf, cgeom, step);
+        fill(fmf, fgeom, step);
+        probes.write({&cmf, &fmf}, {cgeom, fgeom}, {ratio}, step, Real(0.5)*step);
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ifstream ifs(filename, std::ios::binary);
+        std::string magic;
+        Long nc, np, record_size;
+        ifs >> magic >> nc >> np >> record_size;
+        AMREX_ALWAYS_ASSERT(magic == "AMReX-ProbeSet-V1" && nc == 2 && np == 3 &&
+                            record_size == probes.recordSize());
+        std::string name;
+        for (int n = 0; n < nc; ++n) { ifs >> name; }
+        Vector<Box> boxes(np);
+        for (auto& bx : boxes) {
+            std::string type;
+            Real x;
+            ifs >> name >> type >> bx;
+            for (int i = 0; i < 2*AMREX_SPACEDIM; ++i) { ifs >> x; }
+        }
+        ifs >> name;
+        AMREX_ALWAYS_ASSERT(name == "end_header");
+        ifs.ignore(1);
+
+        // The plane and the line go through the fine level, the point is
+        // on the coarse level only.
+        const int kz = static_cast<int>(Real(0.6)*fgeom.Domain().length(AMREX_SPACEDIM-1));
+        AMREX_ALWAYS_ASSERT(boxes[0].numPts() == fgeom.Domain().numPts()/fgeom.Domain().length(AMREX_SPACEDIM-1)
+                            && boxes[0].smallEnd(AMREX_SPACEDIM-1) == kz);
+        AMREX_ALWAYS_ASSERT(boxes[1].length(0) == fgeom.Domain().length(0));
+        AMREX_ALWAYS_ASSERT(boxes[2].numPts() == 1 && !fba.contains(boxes[2].smallEnd()));
+
+        auto const& cproblo = cgeom.ProbLoArray();
+        auto const& cdx = cgeom.CellSizeArray();
+        auto const& fproblo = fgeom.ProbLoArray();
+        auto const& fdx = fgeom.CellSizeArray();
+        Vector<double> record(record_size);
+        Long nfine = 0;
+        for (int step = 0; step < nsteps; ++step) {
+            std::int64_t s;
+            double t;
+            ifs.read(reinterpret_cast<char*>(&s), sizeof(s));
+            ifs.read(reinterpret_cast<char*>(&t), sizeof(t));
+            ifs.read(reinterpret_cast<char*>(record.data()), std::streamsize(record_size*sizeof(double)));
+            AMREX_ALWAYS_ASSERT(ifs.good() && s == step && t == double(Real(0.5)*step));
+
+            Long m = 0;
+            for (auto const& bx : boxes) {
+                for (int n = 0; n < nc; ++n) {
+                    amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+                    {
+                        amrex::ignore_unused(j,k);
+                        const IntVect iv(AMREX_D_DECL(i,j,k));
+                        Real expected;
+                        if (fba.contains(iv)) {
+                            expected = field(iv, scomp+n, step, fproblo, fdx);
+                            ++nfine;
+                        } else {
+                            expected = field(amrex::coarsen(iv,ratio), scomp+n, step, cproblo, cdx);
+                        }
+                        const double got = record[m++];
+                        AMREX_ALWAYS_ASSERT(std::abs(got - double(expected)) <= 1.e-12*std::abs(double(expected)));
+                    });
+                }
+            }
+            AMREX_ALWAYS_ASSERT(m == record_size);
+        }
+        AMREX_ALWAYS_ASSERT(nfine > 0 && nfine < nsteps*record_size);
+        ifs.peek();
+        AMREX_ALWAYS_ASSERT(ifs.eof());
+    }
+
+    amrex::Print() << "ProbeSet passed\n";
+}